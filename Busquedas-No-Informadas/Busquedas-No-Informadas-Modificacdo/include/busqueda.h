@@ -2,9 +2,19 @@
 #define BUSQUEDA_H
 
 #include "grafo.h"
+#include "grafo_csr.h"
+#include "marcas.h"
+#include "monticulo_radix.h"
 #include "nodo.h"
+#include "soluciones.h"
 #include "trace.h"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 
 /**
  * @brief Nodo del árbol de búsqueda.
@@ -12,12 +22,104 @@
  *         - padre_idx: índice en un vector 'arbol' (o -1 si es la raíz).
  *         - coste_acumulado: coste acumulado hasta este nodo.
  *         - profundidad: número de niveles desde el estado inicial.
+ *         - firma: máscara de 64 bits con un bit por cada vértice del camino desde la raíz
+ *                  (bit id % 64). Si el bit de un vértice no está, seguro que no está en el
+ *                  camino; si está, hay que comprobarlo subiendo por padre_idx.
  */
 struct NodoArbol {
   int id;           
   int padre_idx; 
   double coste_acumulado; 
   int profundidad;  
+  std::uint64_t firma = 0;
+};
+
+/**
+ * @brief Almacén de los nodos del árbol de búsqueda, por trozos de tamaño fijo.
+ *
+ * Sustituye al std::vector<NodoArbol> de cada búsqueda: los nodos se guardan en
+ * trozos de kNodosPorTrozo que nunca se mueven, así que crecer no copia nada y las
+ * referencias a un nodo siguen valiendo aunque se añadan más. Los índices son los
+ * mismos que daría el vector (0, 1, 2... en orden de inserción). Reiniciar() no
+ * libera los trozos: la siguiente búsqueda con el mismo objeto busqueda los reutiliza
+ * y, una vez alcanzado el tamaño de la búsqueda más grande, ya no se reserva memoria.
+ */
+class ArenaArbol {
+ public:
+  static constexpr std::size_t kBitsTrozo = 12;
+  static constexpr std::size_t kNodosPorTrozo = std::size_t{1} << kBitsTrozo;
+
+  /**
+   * @brief Vacía el árbol en O(1) (conserva los trozos para reutilizarlos).
+   */
+  void Reiniciar() { tamano_ = 0; }
+
+  bool Vacio() const { return tamano_ == 0; }
+
+  std::size_t Tamano() const { return tamano_; }
+
+  /**
+   * @brief Añade un nodo al final.
+   * @return Índice del nodo añadido.
+   */
+  int Anadir(const NodoArbol& nodo) {
+    if (tamano_ == trozos_.size() * kNodosPorTrozo) trozos_.emplace_back(new NodoArbol[kNodosPorTrozo]);
+    (*this)[tamano_] = nodo;
+    return static_cast<int>(tamano_++);
+  }
+
+  /**
+   * @brief Quita el último nodo (para usar el árbol como pila).
+   */
+  void QuitarUltimo() { --tamano_; }
+
+  NodoArbol& operator[](std::size_t i) { return trozos_[i >> kBitsTrozo][i & (kNodosPorTrozo - 1)]; }
+  const NodoArbol& operator[](std::size_t i) const { return trozos_[i >> kBitsTrozo][i & (kNodosPorTrozo - 1)]; }
+
+ private:
+  std::vector<std::unique_ptr<NodoArbol[]>> trozos_;  ///< Trozos reservados (no se liberan al reiniciar).
+  std::size_t tamano_ = 0;                            ///< Nodos en uso.
+};
+
+/**
+ * @brief Estado de uno de los dos lados de la BFS bidireccional.
+ *         - visitados: vértices alcanzados desde este lado.
+ *         - padre: vértice desde el que se alcanzó cada uno (válido si está en visitados).
+ *         - nivel: distancia en aristas al extremo de este lado (válido si está en visitados).
+ *         - frontera: vértices del último nivel alcanzado, pendientes de expandir.
+ *        Se guarda en la clase busqueda para reutilizar la memoria entre búsquedas.
+ */
+struct LadoBidireccional {
+  MarcasVertice visitados;
+  std::vector<int> padre;
+  std::vector<int> nivel;
+  std::vector<int> frontera;
+};
+
+/**
+ * @brief Estado por vértice de BfsParalelo.
+ *         - visitados: vértices ya generados.
+ *         - padre: vértice desde el que se generó cada uno (válido si está en visitados).
+ *         - pos_padre: durante un nivel, posición en la frontera del padre candidato de
+ *           cada vértice nuevo (los hilos se quedan con la mínima con un mínimo atómico).
+ *         - pos_en_frontera: posición en la frontera de cada vértice que se expande.
+ *         - frontera, siguiente, nuevos_por_hilo: niveles actual y siguiente, y los
+ *           vértices nuevos que encuentra cada hilo.
+ *         - a_medias: la última búsqueda no terminó (excepción) y pos_padre o
+ *           pos_en_frontera pueden no estar limpios.
+ *        Entre niveles, pos_padre y pos_en_frontera valen "sin padre" en todos los
+ *        vértices, así que no hay que rellenarlos al empezar otra búsqueda. Se guarda en
+ *        la clase busqueda para reutilizar la memoria entre búsquedas.
+ */
+struct EstadoBfsParalelo {
+  MarcasVertice visitados;
+  std::vector<int> padre;
+  std::vector<std::atomic<int>> pos_padre;
+  std::vector<int> pos_en_frontera;
+  std::vector<int> frontera;
+  std::vector<int> siguiente;
+  std::vector<std::vector<int>> nuevos_por_hilo;
+  bool a_medias = false;
 };
 
 /**
@@ -31,11 +133,23 @@ class busqueda {
    * @param origen Identificador del nodo de origen (1-based).
    * @param destion Identificador del nodo destion (1-based).
    * @param opts Opciones para la búsqueda (criterio de parada, orden de vecinos).
+   * @param receptor Si se da, recibe cada solución según se encuentra (camino y coste)
+   *                 y resultado.camino no se rellena; si devuelve false, la búsqueda
+   *                 termina ahí. Sirve para enumerar todas las soluciones sin parar en
+   *                 la primera y sin perder las anteriores (ver ColectorSoluciones).
    * @return Resultado de la búsqueda, incluyendo si se encontró el destino,
    *         el camino desde origen a destino, el coste total, la traza de
    *         la búsqueda, y el total de nodos generados e inspeccionados.
    */
-  trace::ResultadoBusqueda Bfs(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts);
+  trace::ResultadoBusqueda Bfs(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                               const ReceptorSoluciones& receptor = ReceptorSoluciones());
+
+  /**
+   * @brief BFS sobre un grafo congelado en formato CSR. Misma traza y resultado que
+   *        la versión sobre Grafo, pero la expansión recorre arrays contiguos.
+   */
+  trace::ResultadoBusqueda Bfs(const GrafoCsr& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                               const ReceptorSoluciones& receptor = ReceptorSoluciones());
 
   /**
    * @brief Realiza una búsqueda en profundidad (DFS) en el grafo dado.
@@ -43,12 +157,219 @@ class busqueda {
    * @param origen Identificador del nodo de origen (1-based).
    * @param destion Identificador del nodo destion (1-based).
    * @param opts Opciones para la búsqueda (criterio de parada, orden de vecinos).
+   * @param receptor Como en Bfs: recibe cada solución según se encuentra.
    * @return Resultado de la búsqueda, incluyendo si se encontró el destino,
    *         el camino desde origen a destino, el coste total, la traza de
    *         la búsqueda, y el total de nodos generados e inspeccionados.
    */
-  trace::ResultadoBusqueda Dfs(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts);
+  trace::ResultadoBusqueda Dfs(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                               const ReceptorSoluciones& receptor = ReceptorSoluciones());
+
+  /**
+   * @brief DFS sobre un grafo congelado en formato CSR (misma traza que sobre Grafo).
+   */
+  trace::ResultadoBusqueda Dfs(const GrafoCsr& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                               const ReceptorSoluciones& receptor = ReceptorSoluciones());
+
+  trace::ResultadoBusqueda BfsModi(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                   const ReceptorSoluciones& receptor = ReceptorSoluciones());
+
+  /**
+   * @brief BfsModi sobre un grafo congelado en formato CSR (misma traza que sobre Grafo).
+   */
+  trace::ResultadoBusqueda BfsModi(const GrafoCsr& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                   const ReceptorSoluciones& receptor = ReceptorSoluciones());
+
+  /**
+   * @brief Realiza una búsqueda de coste uniforme (UCS) en el grafo dado: inspecciona
+   *        siempre el nodo de la frontera con menor coste acumulado, así que el primer
+   *        camino que llega al destino es el de menor coste.
+   *
+   *        Es siempre búsqueda en grafo (cada vértice se inspecciona una vez, con su
+   *        coste óptimo). La frontera es un montículo radix con borrado perezoso: si
+   *        se encuentra un camino mejor a un vértice ya generado se genera de nuevo y
+   *        la entrada antigua se descarta al sacarla, sin contar como iteración.
+   * @param g Grafo donde se realiza la búsqueda.
+   * @param origen Identificador del nodo de origen (1-based).
+   * @param destino Identificador del nodo destino (1-based).
+   * @param opts Opciones para la búsqueda (criterio de parada).
+   * @return Resultado de la búsqueda con el camino de menor coste, si existe.
+   */
+  trace::ResultadoBusqueda Ucs(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts);
+
+  /**
+   * @brief UCS sobre un grafo congelado en formato CSR (misma traza que sobre Grafo).
+   */
+  trace::ResultadoBusqueda Ucs(const GrafoCsr& g, int origen, int destino, const trace::OpcionesBusqueda& opts);
+
+  /**
+   * @brief Realiza una BFS bidireccional: crece a la vez desde el origen y desde el
+   *        destino, expandiendo en cada iteración un nivel completo del lado con la
+   *        frontera más pequeña, hasta que los dos lados se tocan. Explora O(b^(d/2))
+   *        nodos en lugar de O(b^d).
+   *
+   *        Es búsqueda en grafo y devuelve un camino con el mínimo número de aristas
+   *        (al encontrarse los lados se termina el nivel y se elige el encuentro más
+   *        corto). Siempre se detiene en esa primera solución. En la traza, cada
+   *        iteración es un nivel expandido (de cualquiera de los dos lados).
+   * @param g Grafo donde se realiza la búsqueda (no dirigido).
+   * @param origen Identificador del nodo de origen (1-based).
+   * @param destino Identificador del nodo destino (1-based).
+   * @param opts Opciones para la búsqueda (no se usan: siempre para en la primera solución).
+   * @return Resultado de la búsqueda con el camino unido y su coste total.
+   */
+  trace::ResultadoBusqueda BfsBidireccional(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts);
+
+  /**
+   * @brief BFS bidireccional sobre un grafo congelado en formato CSR (misma traza que sobre Grafo).
+   */
+  trace::ResultadoBusqueda BfsBidireccional(const GrafoCsr& g, int origen, int destino,
+                                            const trace::OpcionesBusqueda& opts);
+
+  /**
+   * @brief Realiza una búsqueda en profundidad iterativa (IDDFS): repite una DFS en
+   *        árbol con límite de profundidad 0, 1, 2... hasta encontrar el destino o
+   *        hasta que el árbol entero quepa en el límite.
+   *
+   *        Encuentra el camino con menos aristas, como Bfs, pero solo guarda el camino
+   *        actual y un cursor de vecinos por nivel, así que la memoria de la búsqueda es
+   *        O(profundidad). Cada límite es una iteración de la traza, con los nodos
+   *        inspeccionados y generados en esa pasada (el origen se genera en todas).
+   *        Si no se para en la primera solución, se termina la pasada en la que se
+   *        encontró y se enumeran todas las soluciones de esa profundidad mínima.
+   * @param g Grafo donde se realiza la búsqueda.
+   * @param origen Identificador del nodo de origen (1-based).
+   * @param destino Identificador del nodo destino (1-based).
+   * @param opts Opciones para la búsqueda (criterio de parada).
+   * @return Resultado de la búsqueda; el camino es el último encontrado.
+   */
+  trace::ResultadoBusqueda Iddfs(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts);
+
+  /**
+   * @brief IDDFS sobre un grafo congelado en formato CSR (misma traza que sobre Grafo).
+   */
+  trace::ResultadoBusqueda Iddfs(const GrafoCsr& g, int origen, int destino, const trace::OpcionesBusqueda& opts);
+
+  /**
+   * @brief Realiza una BFS en grafo desde origen hasta agotar la frontera, sin destino.
+   *        Cada vértice guarda el vértice desde el que se generó la primera vez, así
+   *        que con una sola búsqueda se obtiene el camino con menos aristas (y su coste)
+   *        desde el origen a cualquier destino con ArbolCaminos::ExtraerCamino.
+   *
+   *        La traza es la misma que daría Bfs en modo búsqueda en grafo con un destino
+   *        inalcanzable.
+   * @param g Grafo donde se realiza la búsqueda.
+   * @param origen Identificador del nodo de origen (1-based).
+   * @return Árbol de caminos desde el origen, con la traza y los contadores.
+   * @throw std::out_of_range Si origen no es un vértice del grafo.
+   */
+  trace::ArbolCaminos BfsTodos(const Grafo& g, int origen);
+
+  /**
+   * @brief BfsTodos sobre un grafo congelado en formato CSR (misma traza que sobre Grafo).
+   */
+  trace::ArbolCaminos BfsTodos(const GrafoCsr& g, int origen);
+
+  /**
+   * @brief BFS en grafo síncrona por niveles y en paralelo, para consultas sueltas sobre
+   *        grafos muy grandes. Cada nivel se expande entre varios hilos, que reclaman los
+   *        vértices nuevos con operaciones atómicas. Cuando la frontera es grande se pasa
+   *        a expansión ascendente (cada vértice no visitado busca a su padre en la
+   *        frontera), que recorre muchas menos aristas (BFS de dirección optimizada).
+   *
+   *        Devuelve el mismo camino que Bfs en modo búsqueda en grafo: cada vértice se
+   *        queda con el padre que aparece antes en la frontera y cada nivel se ordena como
+   *        lo haría la cola secuencial. La traza tiene una iteración por nivel, con los
+   *        nodos inspeccionados y generados en ese nivel en el mismo orden que la
+   *        secuencial (los totales coinciden).
+   * @param g Grafo donde se realiza la búsqueda.
+   * @param origen Identificador del nodo de origen (1-based).
+   * @param destino Identificador del nodo destino (1-based).
+   * @param opts Opciones para la búsqueda (criterio de parada).
+   * @param hilos Número de hilos (0 = los que tenga la máquina).
+   * @return Resultado de la búsqueda.
+   * @throw std::invalid_argument Si hilos < 0.
+   */
+  trace::ResultadoBusqueda BfsParalelo(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                       int hilos = 0);
+
+  /**
+   * @brief BFS paralela sobre un grafo congelado en formato CSR (misma traza que sobre Grafo).
+   */
+  trace::ResultadoBusqueda BfsParalelo(const GrafoCsr& g, int origen, int destino,
+                                       const trace::OpcionesBusqueda& opts, int hilos = 0);
+
+  /**
+   * @brief DFS exhaustiva en paralelo (búsqueda en árbol sin parar en la primera
+   *        solución), para recorrer todos los caminos simples desde el origen. Cada hilo
+   *        explora subárboles en su propia deque; cuando alguno se queda sin trabajo, los
+   *        demás le ceden los hermanos pendientes del nivel más alto de su pila y él los
+   *        roba por el otro extremo de la deque.
+   *
+   *        Los nodos generados e inspeccionados coinciden con los de Dfs, y el camino
+   *        devuelto es la última solución que encontraría Dfs. La traza solo recoge la
+   *        generación del origen: la completa tendría una iteración por nodo del árbol.
+   *        Con parada en la primera solución, en búsqueda en grafo o con k_mejores el
+   *        resultado depende del orden del recorrido, así que se hace Dfs secuencial.
+   * @param g Grafo donde se realiza la búsqueda.
+   * @param origen Identificador del nodo de origen (1-based).
+   * @param destino Identificador del nodo destino (1-based).
+   * @param opts Opciones para la búsqueda.
+   * @param hilos Número de hilos (0 = los que tenga la máquina).
+   * @return Resultado de la búsqueda.
+   * @throw std::invalid_argument Si hilos < 0.
+   */
+  trace::ResultadoBusqueda DfsParalelo(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                       int hilos = 0);
+
+  /**
+   * @brief DFS exhaustiva paralela sobre un grafo congelado en formato CSR.
+   */
+  trace::ResultadoBusqueda DfsParalelo(const GrafoCsr& g, int origen, int destino,
+                                       const trace::OpcionesBusqueda& opts, int hilos = 0);
+
+  /**
+   * @brief Calcula los k caminos simples más baratos de origen a destino (algoritmo de
+   *        Yen). Cada camino nuevo sale de desviar uno ya aceptado en uno de sus vértices,
+   *        buscando el camino más corto desde ahí sin repetir la parte anterior ni los
+   *        caminos aceptados con esa misma parte.
+   *
+   *        Se hace una sola búsqueda de Dijkstra desde el destino y sus distancias se
+   *        reutilizan en todos los desvíos: si el camino más corto del vértice de desvío
+   *        sigue siendo válido se usa directamente, y si no se busca con A* usando esas
+   *        distancias como heurística. Solo se prueban los desvíos a partir del punto en
+   *        que cada camino se separó de su padre (mejora de Lawler). El coste es del orden
+   *        de k · longitud · (búsqueda de camino más corto), no exponencial como recorrer
+   *        el árbol entero.
+   *
+   *        Los caminos quedan en resultado.mejores de menor a mayor coste, y camino /
+   *        coste_total es el más barato. Los contadores suman todos los nodos de Dijkstra
+   *        y de las búsquedas A*; la traza solo recoge la generación del origen.
+   * @param g Grafo donde se realiza la búsqueda (no dirigido, pesos no negativos).
+   * @param origen Identificador del nodo de origen (1-based).
+   * @param destino Identificador del nodo destino (1-based).
+   * @param k Número de caminos (puede haber menos si no hay tantos caminos simples).
+   * @return Resultado con los k caminos más baratos.
+   * @throw std::out_of_range Si origen o destino no son vértices del grafo.
+   * @throw std::invalid_argument Si k == 0 o hay pesos negativos.
+   */
+  trace::ResultadoBusqueda KCaminosMasCortos(const Grafo& g, int origen, int destino, size_t k);
+
+  /**
+   * @brief KCaminosMasCortos sobre un grafo congelado en formato CSR.
+   */
+  trace::ResultadoBusqueda KCaminosMasCortos(const GrafoCsr& g, int origen, int destino, size_t k);
 
-  trace::ResultadoBusqueda BfsModi(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts);
+ private:
+  MarcasVertice generados_;  ///< Vértices ya generados en búsqueda en grafo (se reutiliza entre búsquedas).
+  MarcasVertice en_camino_;  ///< Vértices del camino actual de Dfs e Iddfs (comprobación de ciclos en O(1)).
+  MarcasVertice cerrados_;   ///< Vértices ya inspeccionados por Ucs.
+  std::vector<double> mejor_coste_;     ///< Mejor coste conocido por vértice en Ucs (válido si está en generados_).
+  MonticuloRadix<int> frontera_ucs_;    ///< Frontera de Ucs (índices de 'arbol' por coste acumulado).
+  LadoBidireccional lado_origen_;       ///< Lado del origen en BfsBidireccional.
+  LadoBidireccional lado_destino_;      ///< Lado del destino en BfsBidireccional.
+  EstadoBfsParalelo bfs_paralelo_;      ///< Estado por vértice de BfsParalelo.
+  std::vector<int> camino_solucion_;    ///< Camino que se entrega a un ReceptorSoluciones (se reutiliza).
+  ArenaArbol arbol_;                    ///< Nodos del árbol de Bfs, Dfs, BfsModi y Ucs (se reutiliza).
 };
 #endif  // BUSQUEDA_H
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace checksum {
+
+/// Valor inicial del hash (offset basis de FNV-1a de 64 bits).
+constexpr std::uint64_t kBase = 14695981039346656037ULL;
+
+/**
+ * @brief Hash FNV-1a de 64 bits aplicado por palabras de 8 bytes (los bytes
+ *        finales que no completan palabra se procesan de uno en uno).
+ *
+ *        Procesar por palabras es unas 8 veces más rápido que byte a byte y basta
+ *        para detectar ficheros corruptos o modificados (no es criptográfico).
+ *        Se puede encadenar: Fnv1a64(b, nb, Fnv1a64(a, na)) es el hash de a seguido
+ *        de b siempre que na sea múltiplo de 8.
+ * @param datos Bytes a resumir.
+ * @param tamano Número de bytes.
+ * @param h Estado inicial (kBase o el resultado de una llamada anterior).
+ * @return Hash de los datos.
+ */
+inline std::uint64_t Fnv1a64(const void* datos, std::size_t tamano, std::uint64_t h = kBase) {
+  constexpr std::uint64_t kPrimo = 1099511628211ULL;
+  const unsigned char* p = static_cast<const unsigned char*>(datos);
+  std::size_t k = 0;
+  for (; k + 8 <= tamano; k += 8) {
+    std::uint64_t palabra;
+    std::memcpy(&palabra, p + k, sizeof(palabra));
+    h = (h ^ palabra) * kPrimo;
+  }
+  for (; k < tamano; ++k) h = (h ^ p[k]) * kPrimo;
+  return h;
+}
+
+}  // namespace checksum
+
+#endif  // CHECKSUM_H
@@ -0,0 +1,57 @@
+#ifndef FICHERO_MAPEADO_H
+#define FICHERO_MAPEADO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Fichero de solo lectura proyectado en memoria (mmap).
+ *
+ * Permite leer un fichero entero como un bloque contiguo de chars sin
+ * copiarlo: el sistema operativo trae las páginas bajo demanda. El mapeo
+ * se deshace al destruir el objeto, así que los punteros que devuelve
+ * Datos() solo son válidos mientras viva.
+ *
+ * No se puede copiar, solo mover.
+ */
+class FicheroMapeado {
+ public:
+  /**
+   * @brief Proyecta un fichero en memoria.
+   * @param ruta Ruta del fichero a proyectar.
+   * @throws std::runtime_error Si no se puede abrir o proyectar el fichero.
+   */
+  explicit FicheroMapeado(const std::string& ruta);
+
+  ~FicheroMapeado();
+
+  FicheroMapeado(const FicheroMapeado&) = delete;
+  FicheroMapeado& operator=(const FicheroMapeado&) = delete;
+  FicheroMapeado(FicheroMapeado&& otro) noexcept;
+  FicheroMapeado& operator=(FicheroMapeado&& otro) noexcept;
+
+  /**
+   * @brief Devuelve el inicio del contenido del fichero (nullptr si está vacío).
+   */
+  const char* Datos() const { return datos_; }
+
+  /**
+   * @brief Devuelve el tamaño del fichero en bytes.
+   */
+  std::size_t Tamano() const { return tamano_; }
+
+  /**
+   * @brief Devuelve la fecha de última modificación del fichero (nanosegundos desde epoch).
+   */
+  std::uint64_t ModificacionNs() const { return modificacion_ns_; }
+
+ private:
+  const char* datos_ = nullptr;  ///< Inicio de la proyección (nullptr si el fichero está vacío).
+  std::size_t tamano_ = 0;       ///< Tamaño del fichero en bytes.
+  std::uint64_t modificacion_ns_ = 0;  ///< mtime del fichero al proyectarlo.
+
+  void Liberar();  ///< Deshace la proyección, si la hay.
+};
+
+#endif  // FICHERO_MAPEADO_H
@@ -42,7 +42,7 @@ class Grafo {
      * @brief Verifica si existe una arista entre dos nodos del grafo.
      * @param u Identificador del primer ndodo (1-based).
      * @param v Identificador del segundo nodo (1-based).
-     * @return true si existe la arista entre u y v, false en caso contrario.
+     * @return true si existe la arista entre u y v (o si u == v, porque d(i,i) = 0), false en caso contrario.
      */
     bool ExisteArista(int u, int v) const;
 
@@ -50,7 +50,10 @@ class Grafo {
      * @brief Devuelve el peso de la arista entre dos nodos del grafo.
      * @param u Identificador del primer nodo (1-based).
      * @param v Identificador del segundo nodo (1-based).
-     * @return Peso de la arista entre u y v, o -1 si no existe la arista.
+     * @return Peso de la arista entre u y v, 0 si u == v, o -1 si no existe la arista.
+     * 
+     * @note El peso se busca en la lista de vecinos (ordenada) del extremo con menor grado,
+     *       así que la memoria del grafo es O(N + M), sin matriz NxN.
      */
     double GetPesoArista(int u, int v) const;
 
@@ -74,6 +77,8 @@ class Grafo {
     const Nodo& GetNodoPorId(int id) const;
 
  private:
+  friend class GrafoBuilder;  ///< Rellena nodos_ en bloque (ver grafo_builder.h).
+
   int num_vertices_;    ///< Contiene el número de vertices (1..N)
   
   // Recordar que los dos vectores estan en base 0, entonces
@@ -82,8 +87,6 @@ class Grafo {
   // estan en base 1 y los vectores en base 0
   std::vector<Nodo> nodos_;   ///< Contiene todos los nodos (en 0-based y cada uno con su id y vecinos)
 
-  std::vector<std::vector<double>> pesos_;  ///< (0-based) Matriz de adyacencia ponderada (N = num_aristas)(NxN): coste de la arista o -1 si no existe.
-
   void VerificarVerticeOExcepcion(int u) const; ///< Verifica que u está en [1, num_vertices_], si no lanza excepción.
 };
 
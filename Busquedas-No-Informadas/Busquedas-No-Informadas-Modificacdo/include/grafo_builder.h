@@ -0,0 +1,86 @@
+#ifndef GRAFO_BUILDER_H
+#define GRAFO_BUILDER_H
+
+#include "grafo.h"
+#include "grafo_csr.h"
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+/**
+ * @brief Construye un Grafo añadiendo las aristas en bloque.
+ *
+ * Grafo::AnadirAristaNoDirigida mantiene las listas de vecinos ordenadas y sin
+ * duplicados en cada inserción, lo que cuesta O(grado) por arista. GrafoBuilder
+ * solo apunta las aristas y hace todo el trabajo una vez en Construir():
+ * reparte las aristas por vértice, ordena cada lista una sola vez y elimina
+ * duplicados. El coste total es O(N + M log grado).
+ *
+ * Se mantiene la misma regla que Grafo: si una arista {u, v} se añade varias
+ * veces, se queda el último peso.
+ */
+class GrafoBuilder {
+ public:
+  /**
+   * @brief Crea un constructor para un grafo de num_vertices vértices.
+   * @param num_vertices Número de vértices del grafo (>= 1).
+   * @throw std::invalid_argument Si num_vertices < 1.
+   */
+  explicit GrafoBuilder(int num_vertices);
+
+  /**
+   * @brief Devuelve el número de vértices del grafo que se va a construir.
+   * @return Número de vértices.
+   */
+  int GetNumVertices() const { return num_vertices_; }
+
+  /**
+   * @brief Reserva memoria para un número de aristas conocido de antemano.
+   * @param num_aristas Número de aristas (no dirigidas) que se esperan.
+   */
+  void ReservarAristas(std::size_t num_aristas) { aristas_.reserve(num_aristas); }
+
+  /**
+   * @brief Apunta una arista no dirigida entre u y v.
+   * @param u Identificador del primer nodo (1-based).
+   * @param v Identificador del segundo nodo (1-based).
+   * @param peso Peso de la arista (>= 0).
+   *
+   * @throw std::out_of_range Si u o v están fuera del rango [1, num_vertices].
+   * @throw std::invalid_argument Si u == v o si peso < 0.
+   */
+  void AnadirAristaNoDirigida(int u, int v, double peso);
+
+  /**
+   * @brief Construye el grafo con todas las aristas apuntadas.
+   *        Después de llamarlo el builder queda vacío (sin aristas).
+   * @return Grafo con las listas de vecinos ordenadas y sin duplicados.
+   */
+  Grafo Construir();
+
+  /**
+   * @brief Reconstruye un Grafo a partir de un GrafoCsr. Las filas CSR ya están
+   *        ordenadas y sin duplicados, así que se copian tal cual (O(N + M)).
+   * @param csr Grafo CSR de origen.
+   * @return Grafo con la misma adyacencia.
+   */
+  static Grafo DesdeCsr(const GrafoCsr& csr);
+
+ private:
+  /**
+   * @brief Arista tal y como se apunta (en orden de llegada).
+   */
+  struct Arista {
+    int u;
+    int v;
+    double peso;
+  };
+
+  int num_vertices_;               ///< Número de vértices (1..N).
+  std::vector<Arista> aristas_;    ///< Aristas en orden de inserción.
+
+  void VerificarVerticeOExcepcion(int u) const; ///< Verifica que u está en [1, num_vertices_], si no lanza excepción.
+};
+
+#endif  // GRAFO_BUILDER_H
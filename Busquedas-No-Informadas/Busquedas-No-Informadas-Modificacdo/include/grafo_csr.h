@@ -0,0 +1,183 @@
+#ifndef GRAFO_CSR_H
+#define GRAFO_CSR_H
+
+#include "grafo.h"
+#include "fichero_mapeado.h"
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+
+/**
+ * @brief Vista (sin copia) de los vecinos de un nodo en un GrafoCsr.
+ *
+ * Apunta a dos tramos contiguos (ids y pesos) del grafo. Se comporta como
+ * un vector de pares (id, peso) de solo lectura: tiene size(), operator[]
+ * y se puede recorrer con un for de rango, así que BFS/DFS la usan igual
+ * que el vector que devuelve Grafo::GetVecinosPorId.
+ *
+ * Solo es válida mientras viva el GrafoCsr del que sale.
+ */
+class VecinosCsr {
+ public:
+  /**
+   * @brief Iterador de solo lectura que devuelve pares (id, peso) por valor.
+   */
+  class Iterador {
+   public:
+    Iterador(const std::int32_t* id, const double* peso) : id_(id), peso_(peso) {}
+    std::pair<int, double> operator*() const { return {*id_, *peso_}; }
+    Iterador& operator++() { ++id_; ++peso_; return *this; }
+    bool operator!=(const Iterador& otro) const { return id_ != otro.id_; }
+    bool operator==(const Iterador& otro) const { return id_ == otro.id_; }
+
+   private:
+    const std::int32_t* id_;
+    const double* peso_;
+  };
+
+  VecinosCsr(const std::int32_t* ids, const double* pesos, std::size_t tamano)
+      : ids_(ids), pesos_(pesos), tamano_(tamano) {}
+
+  std::size_t size() const { return tamano_; }
+  bool empty() const { return tamano_ == 0; }
+
+  /**
+   * @brief Devuelve el vecino k-ésimo como par (id, peso), sin comprobar rango.
+   */
+  std::pair<int, double> operator[](std::size_t k) const { return {ids_[k], pesos_[k]}; }
+
+  const std::int32_t* Ids() const { return ids_; }
+  const double* Pesos() const { return pesos_; }
+
+  Iterador begin() const { return Iterador(ids_, pesos_); }
+  Iterador end() const { return Iterador(ids_ + tamano_, pesos_ + tamano_); }
+
+ private:
+  const std::int32_t* ids_;   ///< Ids de los vecinos (1-based), ordenados ascendentemente.
+  const double* pesos_;       ///< Peso de la arista a cada vecino (mismo orden que ids_).
+  std::size_t tamano_;        ///< Número de vecinos.
+};
+
+/**
+ * @brief Grafo no dirigido inmutable en formato CSR (compressed sparse row).
+ *
+ * Toda la adyacencia vive en tres arrays contiguos (struct-of-arrays):
+ * - offsets_: N+1 posiciones; los vecinos del vértice v (1-based) están en
+ *   [offsets_[v-1], offsets_[v]).
+ * - ids_: id de cada vecino (1-based), ordenados dentro de cada fila.
+ * - pesos_: peso de cada arista, en paralelo a ids_.
+ *
+ * Como cada arista no dirigida aparece en las filas de sus dos extremos,
+ * ids_ y pesos_ tienen 2*M entradas. El orden de los vecinos es el mismo
+ * que el de Grafo, así que BFS/DFS generan exactamente la misma traza.
+ *
+ * Los tres arrays pueden ser propios (construido desde un Grafo) o una vista
+ * sobre un fichero binario proyectado en memoria (ver io::AbrirGrafoBinario);
+ * en ese caso el GrafoCsr mantiene viva la proyección. Se puede mover pero no copiar.
+ */
+class GrafoCsr {
+ public:
+  /**
+   * @brief Congela un Grafo en formato CSR.
+   * @param grafo Grafo de origen (no se modifica).
+   */
+  explicit GrafoCsr(const Grafo& grafo);
+
+  /**
+   * @brief Crea un GrafoCsr que usa arrays ya preparados en un fichero proyectado, sin copiarlos.
+   * @param mapeo Fichero proyectado que contiene los arrays (se mantiene vivo mientras viva el grafo).
+   * @param num_vertices Número de vértices (>= 1).
+   * @param num_entradas Número de entradas de ids/pesos (2 * número de aristas).
+   * @param offsets N+1 inicios de fila (offsets[0] == 0, offsets[N] == num_entradas).
+   * @param ids Ids (1-based) de los vecinos, ordenados dentro de cada fila.
+   * @param pesos Pesos de las aristas, en paralelo a ids.
+   * @throw std::invalid_argument Si num_vertices < 1 o los offsets extremos no cuadran.
+   */
+  GrafoCsr(std::shared_ptr<const FicheroMapeado> mapeo, int num_vertices, std::uint64_t num_entradas,
+           const std::uint64_t* offsets, const std::int32_t* ids, const double* pesos);
+
+  GrafoCsr(const GrafoCsr&) = delete;
+  GrafoCsr& operator=(const GrafoCsr&) = delete;
+  GrafoCsr(GrafoCsr&&) = default;
+  GrafoCsr& operator=(GrafoCsr&&) = default;
+
+  /**
+   * @brief Devuelve el número de vértices del grafo.
+   * @return Número de vértices del grafo.
+   */
+  int GetNumVertices() const { return num_vertices_; }
+
+  /**
+   * @brief Devuelve el número de aristas (no dirigidas) del grafo.
+   * @return Número de aristas del grafo.
+   */
+  std::size_t GetNumAristas() const { return static_cast<std::size_t>(num_entradas_ / 2); }
+
+  /**
+   * @brief Acceso directo a los arrays CSR (para serializar el grafo).
+   */
+  std::uint64_t GetNumEntradas() const { return num_entradas_; }
+  const std::uint64_t* GetOffsets() const { return offsets_; }
+  const std::int32_t* GetIds() const { return ids_; }
+  const double* GetPesos() const { return pesos_; }
+
+  /**
+   * @brief Verifica si existe una arista entre dos nodos del grafo.
+   * @param u Identificador del primer nodo (1-based).
+   * @param v Identificador del segundo nodo (1-based).
+   * @return true si existe la arista entre u y v (o si u == v), false en caso contrario.
+   * @throw std::out_of_range Si u o v están fuera del rango [1, num_vertices].
+   */
+  bool ExisteArista(int u, int v) const;
+
+  /**
+   * @brief Devuelve el peso de la arista entre dos nodos del grafo.
+   * @param u Identificador del primer nodo (1-based).
+   * @param v Identificador del segundo nodo (1-based).
+   * @return Peso de la arista entre u y v, 0 si u == v, o -1 si no existe la arista.
+   * @throw std::out_of_range Si u o v están fuera del rango [1, num_vertices].
+   */
+  double GetPesoArista(int u, int v) const;
+
+  /**
+   * @brief Devuelve los vecinos de un nodo comprobando el rango del id.
+   * @param id Identificador del nodo (1-based).
+   * @return Vista de pares (id, peso) de los vecinos del nodo.
+   * @throw std::out_of_range Si id está fuera del rango [1, num_vertices].
+   */
+  VecinosCsr GetVecinosPorId(int id) const;
+
+  /**
+   * @brief Devuelve los vecinos de un nodo sin comprobar el rango del id.
+   *        Pensado para el bucle de expansión, donde el id siempre sale del propio grafo.
+   * @param id Identificador del nodo (1-based), debe estar en [1, num_vertices].
+   * @return Vista de pares (id, peso) de los vecinos del nodo.
+   */
+  VecinosCsr GetVecinosSinComprobar(int id) const {
+    const std::uint64_t ini = offsets_[id - 1];
+    const std::uint64_t fin = offsets_[id];
+    return VecinosCsr(ids_ + ini, pesos_ + ini, static_cast<std::size_t>(fin - ini));
+  }
+
+ private:
+  int num_vertices_;                  ///< Número de vértices (1..N).
+  std::uint64_t num_entradas_ = 0;    ///< Número de entradas de ids_/pesos_ (2 * aristas).
+  const std::uint64_t* offsets_ = nullptr;  ///< (0-based) N+1 inicios de fila en ids_/pesos_.
+  const std::int32_t* ids_ = nullptr;       ///< Ids (1-based) de los vecinos, fila a fila.
+  const double* pesos_ = nullptr;           ///< Pesos de las aristas, en paralelo a ids_.
+
+  // Almacenamiento de los arrays cuando son propios (vacío si son una vista).
+  // Mover un vector no mueve sus datos, así que los punteros siguen siendo válidos.
+  std::vector<std::uint64_t> offsets_propios_;
+  std::vector<std::int32_t> ids_propios_;
+  std::vector<double> pesos_propios_;
+  std::shared_ptr<const FicheroMapeado> mapeo_;  ///< Proyección que contiene los arrays (si son una vista).
+
+  void VerificarVerticeOExcepcion(int u) const; ///< Verifica que u está en [1, num_vertices_], si no lanza excepción.
+};
+
+#endif  // GRAFO_CSR_H
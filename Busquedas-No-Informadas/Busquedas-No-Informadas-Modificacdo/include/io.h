@@ -2,8 +2,10 @@
 #define IO_H
 
 #include "grafo.h"
+#include "grafo_csr.h"
 #include "trace.h"
 
+#include <cstdint>
 #include <iosfwd>
 #include <string>
 
@@ -14,15 +16,51 @@ namespace io {
    * @brief Algoritmo de búsqueda a utilizar.
    *         - kBfs: Búsqueda en amplitud (BFS).
    *         - kDfs: Búsqueda en profundidad (DFS).
+   *         - kUcs: Búsqueda de coste uniforme (UCS).
+   *         - kBidireccional: BFS bidireccional (desde origen y destino a la vez).
+   *         - kIddfs: Búsqueda en profundidad iterativa (IDDFS).
+   *         - kBfsParalelo: BFS en grafo paralela por niveles.
+   *         - kDfsParalelo: DFS exhaustiva en paralelo.
+   *         - kYen: k caminos más cortos (algoritmo de Yen; k = OpcionesBusqueda::k_mejores, mínimo 1).
    */
-   enum class Algoritmo { kBfs, kDfs };
+   enum class Algoritmo { kBfs, kDfs, kUcs, kBidireccional, kIddfs, kBfsParalelo, kDfsParalelo, kYen };
+
+  /**
+   * @brief Convierte el nombre de un algoritmo en la línea de órdenes (bfs, dfs, ucs,
+   *        bidir, iddfs, bfs-par, dfs-par, yen) en su valor de Algoritmo.
+   * @param nombre Nombre del algoritmo.
+   * @return Algoritmo correspondiente.
+   * @throws std::runtime_error Si el nombre no corresponde a ningún algoritmo.
+   */
+  Algoritmo AlgoritmoDesdeNombre(const std::string& nombre);
+
+  /**
+   * @brief Devuelve el nombre de un algoritmo tal y como se escribe en la línea de órdenes.
+   * @param algoritmo Algoritmo.
+   * @return Nombre del algoritmo.
+   */
+  std::string NombreAlgoritmo(Algoritmo algoritmo);
+
+  /**
+   * @brief Comprueba que el algoritmo admite las opciones pedidas, para no ignorar en
+   *        silencio las que no usa.
+   *         - k_mejores: solo bfs, dfs, dfs-par y yen.
+   *         - parar_a_primera_solucion y busqueda_en_grafo: ni bidir (para siempre en el
+   *           primer encuentro y sus dos fronteras son ya búsquedas en grafo) ni yen (solo usa k).
+   *         - busqueda_en_grafo: tampoco ucs ni bfs-par, que son siempre búsqueda en grafo,
+   *           ni iddfs, que es siempre búsqueda en árbol.
+   * @param algoritmo Algoritmo de la búsqueda.
+   * @param opts Opciones de la búsqueda.
+   * @throws std::runtime_error Si se pide una opción que el algoritmo no usa.
+   */
+  void ComprobarOpciones(Algoritmo algoritmo, const trace::OpcionesBusqueda& opts);
 
   /**
    * @brief Estructura problema que contiene los datos de lectura
    * - grafo: El grafo donde se realiza la búsqueda.
    * - origen: Nodo de origen (1-based).
    * - destino: Nodo destino (1-based).
-   * - algoritmo: Algoritmo de búsqueda a utilizar (BFS o DFS).
+   * - algoritmo: Algoritmo de búsqueda a utilizar (BFS, DFS, UCS, BFS bidireccional o IDDFS).
    * - opts: Opciones de la búsqueda (criterio de parada, orden de vecinos).
    */
   struct DatosLectura {
@@ -34,7 +72,50 @@ namespace io {
   };
 
   /**
-   * @brief Lee una instancia desde un stream en el formato de la práctica.
+   * @brief Formato del fichero de entrada.
+   *         - kAutomatico: se decide por la primera línea ("N" o "N M") y, si tiene "N M"
+   *           y el fichero podría ser también una matriz triangular, por el número de tokens
+   *           (ante la duda, matriz triangular, como la lectura original).
+   *         - kTriangular: N y después la matriz triangular superior de pesos d(i,j), -1 si no hay arista.
+   *         - kListaAristas: "N M" y después M líneas "u v w".
+   */
+  enum class FormatoEntrada { kAutomatico, kTriangular, kListaAristas };
+
+  /**
+   * @brief Qué se comprueba al abrir un grafo binario (ver AbrirGrafoBinario).
+   *         - kCabecera: solo la cabecera, el tamaño y los offsets extremos, en O(1). El resto
+   *           del fichero se da por bueno: si está corrupto, las búsquedas pueden leer fuera
+   *           de los arrays. Solo para ficheros de confianza.
+   *         - kEstructura: además, offsets crecientes, ids en rango y ordenados en cada fila
+   *           y pesos no negativos, en O(N + M) pero sin calcular el hash.
+   *         - kCompleta: además, el checksum de todo el contenido.
+   */
+  enum class ComprobacionBinario { kCabecera, kEstructura, kCompleta };
+
+  /**
+   * @brief Opciones de lectura de ficheros.
+   *         - hilos: número de hilos para convertir los pesos de la matriz triangular.
+   *             - 1 = lectura secuencial.
+   *             - 0 = tantos como núcleos tenga la máquina.
+   *           Los ficheros pequeños se leen siempre en secuencial.
+   *         - formato: formato del fichero (por defecto se detecta solo).
+   *         - usar_cache: guarda el grafo leído en "<fichero>.<formato>.cache" (formato binario,
+   *           con <formato> = triangular o aristas, ya resuelto si era automático) y, en las
+   *           siguientes lecturas, lo carga de ahí sin volver a trocear el texto. La caché
+   *           se asocia al tamaño, fecha de modificación y hash del contenido del fichero;
+   *           si alguno cambia, se vuelve a leer el texto y se reescribe.
+   *         - comprobacion: qué se comprueba al abrir un grafo binario (por defecto, la estructura).
+   */
+  struct OpcionesLectura {
+    int hilos = 1;
+    FormatoEntrada formato = FormatoEntrada::kAutomatico;
+    bool usar_cache = false;
+    ComprobacionBinario comprobacion = ComprobacionBinario::kEstructura;
+  };
+
+  /**
+   * @brief Lee una instancia desde un stream en el formato de la práctica
+   *        (matriz triangular o lista de aristas, detectado automáticamente).
    * @param in Stream de entrada (por ejemplo, std::cin o un std::ifstream).
    * @return Problema con grafo construido, origen/destino y opciones.
    * @throws std::runtime_error Si hay errores de formato.
@@ -49,6 +130,75 @@ namespace io {
     */
   DatosLectura LeerFichero(const std::string& nombre_fichero);
 
+  /**
+    * @brief Lee una instancia desde un fichero con opciones de lectura.
+    * @param nombre_fichero Nombre del fichero a leer.
+    * @param opciones Opciones de lectura (número de hilos...).
+    * @return Problema con grafo construido, origen/destino y opciones.
+    * @throws std::runtime_error Si no se puede abrir el fichero o hay errores de formato.
+    * @throws std::invalid_argument Si las opciones no son válidas.
+    */
+  DatosLectura LeerFichero(const std::string& nombre_fichero, const OpcionesLectura& opciones);
+
+  /**
+    * @brief Lee el grafo de un fichero en el formato de la práctica y lo congela en formato CSR.
+    * @param nombre_fichero Nombre del fichero a leer.
+    * @return Grafo CSR listo para las búsquedas.
+    * @throws std::runtime_error Si no se puede abrir el fichero o hay errores de formato.
+    */
+  GrafoCsr LeerGrafoCsr(const std::string& nombre_fichero);
+
+  // Formato binario (ver src/io_binario.cc): cabecera versionada con checksum seguida de
+  // los arrays CSR tal cual, para poder proyectar el fichero y buscar sin deserializar.
+
+  /**
+   * @brief Identifica el fichero de texto del que sale un grafo binario (para la caché).
+   *         - tamano: tamaño en bytes del fichero de texto.
+   *         - modificacion_ns: su fecha de última modificación.
+   *         - hash: checksum::Fnv1a64 de todo su contenido.
+   *        Si todos los campos valen 0, el binario no está asociado a ningún fichero.
+   */
+  struct ClaveOrigen {
+    std::uint64_t tamano = 0;
+    std::uint64_t modificacion_ns = 0;
+    std::uint64_t hash = 0;
+
+    bool operator==(const ClaveOrigen& otra) const {
+      return tamano == otra.tamano && modificacion_ns == otra.modificacion_ns && hash == otra.hash;
+    }
+  };
+
+  /**
+    * @brief Guarda un grafo CSR en formato binario.
+    * @param grafo Grafo a guardar.
+    * @param nombre_fichero Fichero de salida (se sobrescribe).
+    * @param clave Fichero de texto del que sale el grafo (solo para la caché).
+    * @throws std::runtime_error Si no se puede escribir el fichero.
+    */
+  void EscribirGrafoBinario(const GrafoCsr& grafo, const std::string& nombre_fichero,
+                            const ClaveOrigen& clave = ClaveOrigen());
+
+  /**
+    * @brief Indica si un fichero empieza con la firma del formato binario.
+    * @param nombre_fichero Fichero a comprobar.
+    * @return true si es un grafo binario, false en caso contrario (o si no se puede leer).
+    */
+  bool EsGrafoBinario(const std::string& nombre_fichero);
+
+  /**
+    * @brief Proyecta un grafo binario en memoria y lo devuelve como GrafoCsr, sin copiar los arrays.
+    * @param nombre_fichero Fichero binario.
+    * @param comprobacion Qué se comprueba antes de dar el grafo por bueno. Por defecto la
+    *        estructura completa (O(N + M)), para que un fichero corrupto no lleve a las
+    *        búsquedas fuera de los arrays; kCabecera deja el arranque en O(1).
+    * @param clave Si no es nullptr, recibe la clave del fichero de texto de origen.
+    * @return Grafo CSR que usa directamente la memoria del fichero.
+    * @throws std::runtime_error Si el fichero no es un grafo binario válido.
+    */
+  GrafoCsr AbrirGrafoBinario(const std::string& nombre_fichero,
+                             ComprobacionBinario comprobacion = ComprobacionBinario::kEstructura,
+                             ClaveOrigen* clave = nullptr);
+
   // Métodos de escritura 
   // Imprimimos la traza
   
@@ -75,7 +225,23 @@ namespace io {
    * @param r Resultado de la búsqueda, incluyendo el camino y coste.
    */
   void ImprimirSolucion(std::ostream& out, const trace::ResultadoBusqueda& r);
+
+  /**
+   * @brief Imprime las k mejores soluciones (ResultadoBusqueda::mejores), de menor a
+   *        mayor coste. No imprime nada si no se pidieron.
+   * @param out Stream de salida.
+   * @param r Resultado de la búsqueda.
+   */
+  void ImprimirMejoresSoluciones(std::ostream& out, const trace::ResultadoBusqueda& r);
   
+  /**
+   * @brief Imprime, para cada vértice, su camino desde el origen y su coste
+   *        (o que no se alcanzó), a partir de una búsqueda desde un único origen.
+   * @param out Stream de salida.
+   * @param caminos Árbol de caminos desde el origen.
+   */
+  void ImprimirCaminos(std::ostream& out, const trace::ArbolCaminos& caminos);
+
     /**
      * @brief Imprime un resumen final de la búsqueda.
      * @param out Stream de salida (por ejemplo, std::cout o un std::ofstream).
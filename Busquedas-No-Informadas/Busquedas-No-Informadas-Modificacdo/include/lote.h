@@ -0,0 +1,134 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include "busqueda.h"
+#include "grafo.h"
+#include "grafo_csr.h"
+#include "io.h"
+#include "trace.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Modo por lotes: se carga el grafo una vez y se resuelven muchas consultas
+ *        (origen, destino, algoritmo, opciones) seguidas sobre él, en lugar de lanzar
+ *        un proceso y leer el fichero del grafo por cada consulta.
+ *
+ * Fichero de consultas: una consulta por línea, con el mismo formato que la línea de
+ * órdenes del modo normal a partir del origen:
+ *
+ *     <origen> <destino> <algoritmo> [--parar] [--en-grafo] [--k <n>]
+ *
+ * Las líneas vacías y las que empiezan por '#' se ignoran. Una línea mal formada no
+ * detiene la lectura: se guarda como consulta con error y su bloque de resultado lo
+ * recoge (y cuenta en EstadisticasLote::errores).
+ */
+namespace lote {
+
+/**
+ * @brief Una consulta del fichero de consultas.
+ *         - origen, destino: vértices (1-based).
+ *         - algoritmo: algoritmo de búsqueda.
+ *         - opts: opciones de la búsqueda.
+ *         - linea: línea del fichero de consultas (para los mensajes).
+ *         - hilos: hilos de los algoritmos paralelos (bfs-par, dfs-par). En el lote vale 1, porque
+ *                  ya se reparten las consultas entre hilos.
+ *         - error: motivo por el que la línea está mal formada (vacío si es válida); en ese
+ *                  caso el resto de campos no se usan.
+ */
+struct Consulta {
+  int origen = 1;
+  int destino = 1;
+  io::Algoritmo algoritmo = io::Algoritmo::kBfs;
+  trace::OpcionesBusqueda opts;
+  int linea = 0;
+  int hilos = 1;
+  std::string error;
+};
+
+/**
+ * @brief Opciones del modo por lotes.
+ *         - traza: si es true, cada bloque de resultado incluye la traza completa
+ *                  (con muchas consultas suele ser lo que más cuesta escribir).
+ *         - hilos: número de hilos que resuelven consultas (0 = los que tenga la máquina).
+ */
+struct OpcionesLote {
+  bool traza = false;
+  int hilos = 1;
+};
+
+/**
+ * @brief Totales de una ejecución por lotes.
+ *         - consultas: consultas resueltas.
+ *         - errores: consultas que no se pudieron resolver (línea mal formada, vértice fuera de rango...).
+ *         - segundos: tiempo de búsqueda y escritura (sin contar la carga del grafo).
+ *         - hilos: hilos que se han usado realmente.
+ */
+struct EstadisticasLote {
+  std::size_t consultas = 0;
+  std::size_t errores = 0;
+  double segundos = 0.0;
+  std::size_t hilos = 1;
+};
+
+/**
+ * @brief Lee un fichero de consultas.
+ * @param ruta Ruta del fichero.
+ * @return Consultas en el orden del fichero (las líneas mal formadas, con Consulta::error).
+ * @throws std::runtime_error Si no se puede abrir el fichero.
+ */
+std::vector<Consulta> LeerConsultas(const std::string& ruta);
+
+/**
+ * @brief Lee consultas de un stream (mismo formato que el fichero).
+ */
+std::vector<Consulta> LeerConsultas(std::istream& in);
+
+/**
+ * @brief Resuelve una consulta con el algoritmo que pide.
+ * @param busq Objeto de búsqueda (se reutilizan sus buffers entre consultas).
+ * @param g Grafo donde se busca.
+ * @param consulta Consulta a resolver.
+ * @return Resultado de la búsqueda.
+ * @throws std::out_of_range Si origen o destino no son vértices del grafo.
+ * @throws std::runtime_error Si la consulta viene de una línea mal formada (Consulta::error).
+ */
+trace::ResultadoBusqueda Buscar(busqueda& busq, const Grafo& g, const Consulta& consulta);
+
+/**
+ * @brief Resuelve una consulta sobre un grafo congelado en formato CSR.
+ */
+trace::ResultadoBusqueda Buscar(busqueda& busq, const GrafoCsr& g, const Consulta& consulta);
+
+/**
+ * @brief Resuelve todas las consultas y escribe un bloque de resultado por consulta,
+ *        siempre en el orden del fichero. Si una consulta falla, su bloque recoge el
+ *        error y se sigue con la siguiente.
+ *
+ *        Con varios hilos, el grafo se comparte en solo lectura y cada hilo tiene su
+ *        propio objeto busqueda (con sus buffers reutilizables). Los hilos van cogiendo
+ *        la siguiente consulta de un contador atómico y dejan su bloque ya formateado en
+ *        una ventana circular; el hilo llamador es el único que escribe en 'out' y lo
+ *        hace en orden, según van estando listos.
+ * @param g Grafo donde se busca (se carga una sola vez fuera; no se modifica).
+ * @param consultas Consultas a resolver.
+ * @param out Stream de salida.
+ * @param opciones Opciones del lote.
+ * @return Totales de la ejecución.
+ * @throws std::invalid_argument Si opciones.hilos < 0.
+ */
+EstadisticasLote EjecutarLote(const Grafo& g, const std::vector<Consulta>& consultas, std::ostream& out,
+                              const OpcionesLote& opciones = OpcionesLote());
+
+/**
+ * @brief EjecutarLote sobre un grafo congelado en formato CSR.
+ */
+EstadisticasLote EjecutarLote(const GrafoCsr& g, const std::vector<Consulta>& consultas, std::ostream& out,
+                              const OpcionesLote& opciones = OpcionesLote());
+
+}  // namespace lote
+
+#endif  // LOTE_H
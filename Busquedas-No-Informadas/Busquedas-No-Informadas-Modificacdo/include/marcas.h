@@ -0,0 +1,51 @@
+#ifndef MARCAS_H
+#define MARCAS_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Conjunto de vértices marcados (1..N) con consulta, marcado y borrado en O(1).
+ *
+ * En lugar de un vector<bool> que habría que poner a false antes de cada búsqueda,
+ * cada vértice guarda el número de "época" en la que se marcó. Vaciar el conjunto
+ * es simplemente pasar a la época siguiente, así que una misma instancia se puede
+ * reutilizar entre búsquedas sin recorrer el array (solo se rellena de ceros al
+ * cambiar de tamaño o cuando el contador de épocas da la vuelta).
+ */
+class MarcasVertice {
+ public:
+  /**
+   * @brief Vacía el conjunto y lo prepara para vértices 1..num_vertices.
+   * @param num_vertices Número de vértices del grafo.
+   */
+  void Reiniciar(int num_vertices) {
+    const std::size_t tamano = static_cast<std::size_t>(num_vertices) + 1;
+    if (sellos_.size() != tamano || epoca_ == UINT32_MAX) {
+      sellos_.assign(tamano, 0);
+      epoca_ = 0;
+    }
+    ++epoca_;
+  }
+
+  /**
+   * @brief Indica si el vértice v está marcado.
+   */
+  bool Marcado(int v) const { return sellos_[static_cast<std::size_t>(v)] == epoca_; }
+
+  /**
+   * @brief Marca el vértice v.
+   */
+  void Marcar(int v) { sellos_[static_cast<std::size_t>(v)] = epoca_; }
+
+  /**
+   * @brief Desmarca el vértice v.
+   */
+  void Desmarcar(int v) { sellos_[static_cast<std::size_t>(v)] = 0; }
+
+ private:
+  std::vector<std::uint32_t> sellos_;  ///< Época en la que se marcó cada vértice (índice 1-based).
+  std::uint32_t epoca_ = 0;            ///< Época actual; 0 nunca es una época válida.
+};
+
+#endif  // MARCAS_H
@@ -0,0 +1,119 @@
+#ifndef MONTICULO_RADIX_H
+#define MONTICULO_RADIX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Montículo radix monótono con claves double no negativas.
+ *
+ * Sirve como cola de prioridad cuando las claves que se sacan nunca decrecen,
+ * como en la búsqueda de coste uniforme con pesos >= 0: toda clave insertada es
+ * mayor o igual que la última que se sacó.
+ *
+ * Los double no negativos conservan el orden si se comparan sus bits como enteros
+ * sin signo, así que se trabaja con esos 64 bits. El elemento con clave x va en la
+ * cubeta b = número de bits significativos de (x XOR ultimo), donde ultimo es la
+ * última clave sacada. Cada elemento solo baja de cubeta, como mucho 64 veces, así
+ * que insertar es O(1) y sacar el mínimo O(log C) amortizado (C = rango de claves),
+ * sin comparaciones entre elementos como en un montículo binario.
+ *
+ * Entre elementos con la misma clave no se garantiza ningún orden.
+ */
+template <typename T>
+class MonticuloRadix {
+ public:
+  /**
+   * @brief Indica si no quedan elementos.
+   */
+  bool Vacio() const { return tamano_ == 0; }
+
+  /**
+   * @brief Devuelve el número de elementos.
+   */
+  std::size_t Tamano() const { return tamano_; }
+
+  /**
+   * @brief Vacía el montículo (conserva la memoria de las cubetas para reutilizarla).
+   */
+  void Vaciar() {
+    for (auto& cubeta : cubetas_) cubeta.clear();
+    ultimo_ = 0;
+    tamano_ = 0;
+  }
+
+  /**
+   * @brief Inserta un elemento.
+   * @param clave Prioridad (>= 0 y >= la última clave sacada).
+   * @param valor Elemento a guardar.
+   * @throw std::invalid_argument Si la clave es negativa o menor que la última sacada.
+   */
+  void Insertar(double clave, T valor) {
+    const std::uint64_t bits = Bits(clave);
+    if (!(clave >= 0.0) || bits < ultimo_) {
+      throw std::invalid_argument("MonticuloRadix: clave negativa o menor que la última sacada");
+    }
+    cubetas_[Cubeta(bits)].emplace_back(bits, std::move(valor));
+    ++tamano_;
+  }
+
+  /**
+   * @brief Saca el elemento de menor clave.
+   * @return Par (clave, elemento).
+   * @throw std::out_of_range Si el montículo está vacío.
+   */
+  std::pair<double, T> SacarMinimo() {
+    if (tamano_ == 0) throw std::out_of_range("MonticuloRadix: montículo vacío");
+    if (cubetas_[0].empty()) {
+      // Primera cubeta no vacía: su mínimo pasa a ser 'ultimo_' y sus elementos se
+      // reparten en cubetas más bajas (el mínimo cae en la 0)
+      std::size_t i = 1;
+      while (cubetas_[i].empty()) ++i;
+      std::uint64_t minimo = cubetas_[i][0].first;
+      for (const auto& elemento : cubetas_[i]) {
+        if (elemento.first < minimo) minimo = elemento.first;
+      }
+      ultimo_ = minimo;
+      for (auto& elemento : cubetas_[i]) {
+        cubetas_[Cubeta(elemento.first)].push_back(std::move(elemento));
+      }
+      cubetas_[i].clear();
+    }
+    auto elemento = std::move(cubetas_[0].back());
+    cubetas_[0].pop_back();
+    --tamano_;
+    return {Double(elemento.first), std::move(elemento.second)};
+  }
+
+ private:
+  // Bits del double como entero sin signo (-0.0 se trata como 0.0)
+  static std::uint64_t Bits(double clave) {
+    if (clave == 0.0) return 0;
+    std::uint64_t bits;
+    std::memcpy(&bits, &clave, sizeof(bits));
+    return bits;
+  }
+
+  static double Double(std::uint64_t bits) {
+    double clave;
+    std::memcpy(&clave, &bits, sizeof(clave));
+    return clave;
+  }
+
+  // Cubeta de una clave: 0 si coincide con 'ultimo_', si no el bit más alto en que difieren + 1
+  std::size_t Cubeta(std::uint64_t bits) const {
+    const std::uint64_t diferencia = bits ^ ultimo_;
+    return diferencia == 0 ? 0 : static_cast<std::size_t>(64 - __builtin_clzll(diferencia));
+  }
+
+  std::array<std::vector<std::pair<std::uint64_t, T>>, 65> cubetas_;  ///< Cubetas por bit más alto distinto.
+  std::uint64_t ultimo_ = 0;  ///< Bits de la última clave sacada.
+  std::size_t tamano_ = 0;    ///< Número de elementos.
+};
+
+#endif  // MONTICULO_RADIX_H
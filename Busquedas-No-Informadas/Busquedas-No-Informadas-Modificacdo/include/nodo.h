@@ -38,9 +38,9 @@ class Nodo {
    * @param vecino_id Identificador del vecino (1-based).
    * @param peso Peso de la arista que conecta este nodo con el vecino (>= 0).
    * 
-   * @note No elimina duplicados: si llamas dos veces con el mismo vecino_id,
-   *       se insertan dos entradas. Normalmente se gestiona desde Grafo para 
-   *       mantener una sola arista por par {u, v}.
+   * @note Si vecino_id ya es vecino, solo se actualiza el peso (gana el último).
+   *       La lista se mantiene ordenada por id insertando en su posición (O(grado)).
+   *       Para cargar muchas aristas de golpe es mejor usar GrafoBuilder.
    */
   void AnadirVecino(int vecino_id, double peso);
 
@@ -51,6 +51,15 @@ class Nodo {
    */
   bool TieneVecino(int vecino_id) const;
 
+  /**
+   * @brief Devuelve el peso de la arista hacia un vecino.
+   * @param vecino_id Identificador del vecino (1-based).
+   * @return Peso de la arista, o -1 si vecino_id no es vecino de este nodo.
+   * 
+   * @note Los vecinos están ordenados por id, así que la búsqueda es binaria (O(log grado)).
+   */
+  double GetPesoVecino(int vecino_id) const;
+
   /**
    * @brief Devuelve la lista de vecinos del nodo.
    * @return Vector de pares (id, peso(costo)) de los vecinos del nodo.
@@ -62,6 +71,15 @@ class Nodo {
    */
   void LimpiarVecinos() { vecinos_.clear(); }
 
+  /**
+   * @brief Sustituye la lista de vecinos de golpe.
+   * @param vecinos Pares (id, peso) ya ordenados por id y sin ids repetidos.
+   * 
+   * @note No se comprueba el orden: lo usa GrafoBuilder, que ya deja cada lista
+   *       ordenada y sin duplicados.
+   */
+  void AsignarVecinos(const std::vector<std::pair<int, double>>& vecinos) { vecinos_ = vecinos; }
+
   /**
    * 
    */
@@ -0,0 +1,133 @@
+#ifndef SOLUCIONES_H
+#define SOLUCIONES_H
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Vista de solo lectura de una solución recién encontrada.
+ *         - vertices: camino desde el origen hasta el destino (longitud vértices).
+ *         - coste: coste total del camino.
+ *        La memoria del camino es de la búsqueda y se reutiliza para la siguiente
+ *        solución: solo es válida durante la llamada al receptor (hay que copiarla
+ *        si se quiere guardar).
+ */
+struct VistaSolucion {
+  const int* vertices = nullptr;
+  std::size_t longitud = 0;
+  double coste = 0.0;
+
+  const int* begin() const { return vertices; }
+  const int* end() const { return vertices + longitud; }
+  int operator[](std::size_t i) const { return vertices[i]; }
+};
+
+/**
+ * @brief Función a la que la búsqueda entrega cada solución según la encuentra.
+ *        Devuelve true para seguir buscando o false para terminar la búsqueda.
+ */
+using ReceptorSoluciones = std::function<bool(const VistaSolucion&)>;
+
+/**
+ * @brief Guarda muchas soluciones compartiendo sus prefijos comunes (un trie de caminos).
+ *
+ * Todas las soluciones de una búsqueda salen del mismo origen, y en Dfs las que se
+ * encuentran seguidas comparten casi todo el camino. Cada nodo del trie es un vértice
+ * con un enlace a su padre, así que una solución nueva solo añade los vértices en que
+ * se separa de las anteriores. Para localizar el hijo se mira primero el último que se
+ * añadió, que en orden de Dfs es casi siempre el bueno.
+ */
+class ColectorSoluciones {
+ public:
+  /**
+   * @brief Añade una solución (copia solo la parte que no comparte con las anteriores).
+   * @throw std::invalid_argument Si el camino está vacío o no empieza en el mismo vértice que los anteriores.
+   */
+  void Anadir(const VistaSolucion& solucion) {
+    if (solucion.longitud == 0) throw std::invalid_argument("ColectorSoluciones: camino vacío");
+    if (nodos_.empty()) nodos_.push_back({solucion[0], -1, -1, -1});
+    if (nodos_[0].vertice != solucion[0]) {
+      throw std::invalid_argument("ColectorSoluciones: las soluciones no salen del mismo origen");
+    }
+    int actual = 0;
+    for (std::size_t i = 1; i < solucion.longitud; ++i) actual = Hijo(actual, solucion[i]);
+    hojas_.push_back(actual);
+    costes_.push_back(solucion.coste);
+  }
+
+  /**
+   * @brief Devuelve un receptor que añade a este colector cada solución y sigue buscando.
+   *        El colector tiene que seguir vivo mientras se use el receptor.
+   */
+  ReceptorSoluciones Receptor() {
+    return [this](const VistaSolucion& solucion) {
+      Anadir(solucion);
+      return true;
+    };
+  }
+
+  /**
+   * @brief Número de soluciones guardadas.
+   */
+  std::size_t NumSoluciones() const { return hojas_.size(); }
+
+  /**
+   * @brief Número de vértices guardados en el trie (lo que ocupan realmente las soluciones).
+   */
+  std::size_t NumNodos() const { return nodos_.size(); }
+
+  /**
+   * @brief Coste de la solución k (en orden de llegada).
+   * @throw std::out_of_range Si k >= NumSoluciones().
+   */
+  double Coste(std::size_t k) const { return costes_.at(k); }
+
+  /**
+   * @brief Reconstruye el camino de la solución k (en orden de llegada).
+   * @throw std::out_of_range Si k >= NumSoluciones().
+   */
+  std::vector<int> Camino(std::size_t k) const {
+    std::vector<int> camino;
+    for (int x = hojas_.at(k); x != -1; x = nodos_[static_cast<std::size_t>(x)].padre) {
+      camino.push_back(nodos_[static_cast<std::size_t>(x)].vertice);
+    }
+    return std::vector<int>(camino.rbegin(), camino.rend());
+  }
+
+  /**
+   * @brief Borra todas las soluciones (conserva la memoria para reutilizarla).
+   */
+  void Vaciar() {
+    nodos_.clear();
+    hojas_.clear();
+    costes_.clear();
+  }
+
+ private:
+  struct Nodo {
+    int vertice;
+    int padre;
+    int ultimo_hijo;  ///< Último hijo añadido (-1 si no tiene).
+    int hermano;      ///< Hermano añadido antes que este (-1 si no hay).
+  };
+
+  // Índice del hijo de 'padre' con ese vértice (lo crea si no existe)
+  int Hijo(int padre, int vertice) {
+    for (int h = nodos_[static_cast<std::size_t>(padre)].ultimo_hijo; h != -1;
+         h = nodos_[static_cast<std::size_t>(h)].hermano) {
+      if (nodos_[static_cast<std::size_t>(h)].vertice == vertice) return h;
+    }
+    const int nuevo = static_cast<int>(nodos_.size());
+    nodos_.push_back({vertice, padre, -1, nodos_[static_cast<std::size_t>(padre)].ultimo_hijo});
+    nodos_[static_cast<std::size_t>(padre)].ultimo_hijo = nuevo;
+    return nuevo;
+  }
+
+  std::vector<Nodo> nodos_;     ///< Nodos del trie; el 0 es el origen.
+  std::vector<int> hojas_;      ///< Nodo final de cada solución.
+  std::vector<double> costes_;  ///< Coste de cada solución.
+};
+
+#endif  // SOLUCIONES_H
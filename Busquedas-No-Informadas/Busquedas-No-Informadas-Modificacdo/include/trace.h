@@ -1,6 +1,9 @@
 #ifndef TRACE_H
 #define TRACE_H
 
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 /**
@@ -31,6 +34,14 @@ struct RegistroIteracion {
   std::vector<int> generados_delta;
 };
 
+/**
+ * @brief Una solución: camino desde el origen al destino (1-based) y su coste.
+ */
+struct Solucion {
+  std::vector<int> camino;
+  double coste = 0.0;
+};
+
 /**
  * @brief Resultado final de la búsqueda.
  *         - Indica si se encontró el nodo objetivo.
@@ -39,6 +50,8 @@ struct RegistroIteracion {
  *         - La traza completa de la búsqueda (registro por iteración).
  *         - Suma de todos los generados_delta.size() = nodos generados totales.
  *         - Suma de todos los inspeccionados_delta.size() = nodos inspeccion
+ *         - mejores: con OpcionesBusqueda::k_mejores > 0, las k soluciones más baratas
+ *                    encontradas, de menor a mayor coste (vacío en otro caso).
  */
 struct ResultadoBusqueda {
   bool found = false;
@@ -47,6 +60,55 @@ struct ResultadoBusqueda {
   std::vector<RegistroIteracion> traza;
   size_t nodos_generados = 0;
   size_t nodos_inspeccionados = 0;
+  std::vector<Solucion> mejores;
+};
+
+/**
+ * @brief Resultado de una búsqueda desde un único origen hacia todos los vértices.
+ *         - origen: vértice origen (1-based).
+ *         - padre[v]: vértice anterior a v en su camino desde el origen (-1 en el origen,
+ *                     0 si v no se alcanzó). Índice 1-based, padre[0] no se usa.
+ *         - coste[v]: coste del camino desde el origen hasta v (si se alcanzó).
+ *         - traza, nodos_generados y nodos_inspeccionados: como en ResultadoBusqueda.
+ *        Con esto se saca el camino a cualquier destino en O(longitud del camino)
+ *        sin repetir la búsqueda.
+ */
+struct ArbolCaminos {
+  int origen = 0;
+  std::vector<int> padre;
+  std::vector<double> coste;
+  std::vector<RegistroIteracion> traza;
+  size_t nodos_generados = 0;
+  size_t nodos_inspeccionados = 0;
+
+  /**
+   * @brief Indica si el destino se alcanzó desde el origen.
+   * @throw std::out_of_range Si destino no es un vértice del grafo.
+   */
+  bool Alcanzado(int destino) const {
+    if (destino < 1 || static_cast<size_t>(destino) >= padre.size()) {
+      throw std::out_of_range("destino fuera de rango");
+    }
+    return padre[destino] != 0;
+  }
+
+  /**
+   * @brief Extrae el camino desde el origen hasta destino y su coste.
+   * @param destino Vértice destino (1-based).
+   * @return ResultadoBusqueda con found, camino y coste_total (sin traza ni contadores).
+   * @throw std::out_of_range Si destino no es un vértice del grafo.
+   */
+  ResultadoBusqueda ExtraerCamino(int destino) const {
+    ResultadoBusqueda resultado;
+    if (!Alcanzado(destino)) return resultado;
+    resultado.found = true;
+    resultado.coste_total = coste[destino];
+    for (int x = destino; x != -1; x = padre[x]) resultado.camino.push_back(x);
+    for (size_t i = 0, j = resultado.camino.size() - 1; i < j; ++i, --j) {
+      std::swap(resultado.camino[i], resultado.camino[j]);
+    }
+    return resultado;
+  }
 };
 
 /**
@@ -57,10 +119,23 @@ struct ResultadoBusqueda {
  *         - vecinos_ascendientes:
  *             - true = expandir vecinos en orden creciente (determinismo).
  *             - false = no ascendientes.
+ *         - busqueda_en_grafo:
+ *             - false = búsqueda en árbol: solo se descarta un vecino si ya está en el camino actual.
+ *             - true = búsqueda en grafo: cada vértice se genera como mucho una vez (conjunto de
+ *                      cerrados), así que el árbol tiene como mucho N nodos y el coste es O(N + M).
+ *         - k_mejores (Bfs, Dfs y BfsModi; tiene sentido sin parar en la primera solución):
+ *             - 0 = no se guardan (camino es la última solución encontrada).
+ *             - k > 0 = se guardan las k soluciones más baratas en ResultadoBusqueda::mejores
+ *                       y camino pasa a ser la más barata (salvo si se da un receptor de
+ *                       soluciones, que deja camino sin rellenar). Cuando ya hay k, no se genera
+ *                       ningún nodo cuyo coste acumulado llegue al de la k-ésima (poda de
+ *                       ramificación y acotación; supone pesos no negativos).
  */
 struct OpcionesBusqueda {
   bool parar_a_primera_solucion = true;
   bool vecinos_ascendientes = true;
+  bool busqueda_en_grafo = false;
+  size_t k_mejores = 0;
 };
 }
 
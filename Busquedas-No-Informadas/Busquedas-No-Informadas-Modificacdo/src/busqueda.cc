@@ -1,15 +1,26 @@
 #include "busqueda.h"
+#include "grafo_csr.h"
+#include "marcas.h"
+#include "monticulo_radix.h"
 
 #include <queue>
 #include <stack>
 #include <stdexcept>
 #include <algorithm>
 #include <random>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
 
 // Namespace con función helper
 namespace {
 //Comprueba si v ya aparece en el camino desde la raíz hasta u_idx
-bool EstaEnCamino(int v, int index_u, const std::vector<NodoArbol>& arbol) {
+bool EstaEnCamino(int v, int index_u, const ArenaArbol& arbol) {
   // Recorremos el camino del arbol de un nodo concreto, sustituyendo el valor por el de padre hasta llegar a 
   // -1, donde se encuentra el origen
   for (int x = index_u; x != -1 ; x = arbol[x].padre_idx) {
@@ -17,9 +28,152 @@ bool EstaEnCamino(int v, int index_u, const std::vector<NodoArbol>& arbol) {
   }
   return false;
 } 
+
+// Bit que ocupa el vértice v en la firma de camino de un NodoArbol
+std::uint64_t BitFirma(int v) {
+  return std::uint64_t{1} << (static_cast<unsigned>(v) & 63u);
+}
+
+// Igual que EstaEnCamino, pero mira antes la firma del nodo: si el bit de v no está
+// puesto, v no está en el camino y nos ahorramos subir por el árbol
+bool EstaEnCaminoConFirma(int v, int index_u, const ArenaArbol& arbol) {
+  if ((arbol[index_u].firma & BitFirma(v)) == 0) return false;
+  return EstaEnCamino(v, index_u, arbol);
+}
+
+// Decide si el vecino v del nodo index_u se descarta. En búsqueda en árbol solo se
+// descartan los ciclos del camino actual; en búsqueda en grafo se descarta cualquier
+// vértice ya generado, y si no lo estaba se marca (porque se va a generar ahora).
+bool DescartarVecino(int v, int index_u, const ArenaArbol& arbol,
+                     bool en_grafo, MarcasVertice& generados) {
+  if (en_grafo) {
+    if (generados.Marcado(v)) return true;
+    generados.Marcar(v);
+    return false;
+  }
+  return EstaEnCaminoConFirma(v, index_u, arbol);
+}
+
+// Acceso a los vecinos para cada representación del grafo. En Grafo usamos el
+// método con comprobación de siempre; en GrafoCsr el acceso sin comprobar, porque
+// los ids que expandimos salen siempre del propio grafo (el origen ya se valida).
+const std::vector<std::pair<int, double>>& Vecinos(const Grafo& g, int id) {
+  return g.GetVecinosPorId(id);
+}
+
+VecinosCsr Vecinos(const GrafoCsr& g, int id) {
+  return g.GetVecinosSinComprobar(id);
+}
+
+// Reconstruye el camino desde la raíz hasta index_hoja usando padre_idx
+// y calcula su coste total sumando los pesos de las aristas.
+template <typename G>
+void ReconstruirSolucion(const G& g, const ArenaArbol& arbol, int index_hoja,
+                         trace::ResultadoBusqueda& resultado) {
+  std::vector<int> camino_rev;
+  for (int x = index_hoja; x != -1; x = arbol[x].padre_idx) {
+    camino_rev.push_back(arbol[x].id);
+  }
+
+  // Invertimos los valores de camino_rev
+  std::reverse(camino_rev.begin(), camino_rev.end());
+
+  // Añadimos el camino al resultado
+  resultado.camino = std::move(camino_rev);
+
+  // Ahora hallamos el coste total
+  resultado.coste_total = 0.0;
+  for (size_t i = 0; i + 1 < resultado.camino.size(); ++i) {
+    resultado.coste_total += g.GetPesoArista(resultado.camino[i], resultado.camino[i + 1]);
+  }
 }
 
-trace::ResultadoBusqueda busqueda::Bfs(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts) {
+// Las k soluciones más baratas encontradas hasta el momento (OpcionesBusqueda::k_mejores),
+// en un montículo de máximos por (coste, orden de llegada): la cima es la k-ésima, la
+// que sale si llega una mejor. Entre soluciones del mismo coste se quedan las primeras.
+class MejoresSoluciones {
+ public:
+  explicit MejoresSoluciones(size_t k) : k_(k) {}
+
+  bool Activo() const { return k_ > 0; }
+
+  // Indica si un nodo con este coste acumulado ya no puede llevar a una de las k mejores
+  bool Podar(double coste) const { return monticulo_.size() == k_ && k_ > 0 && coste >= monticulo_.front().coste; }
+
+  // Guarda la solución que acaba en index_hoja si está entre las k mejores
+  void Anadir(const ArenaArbol& arbol, int index_hoja) {
+    const double coste = arbol[index_hoja].coste_acumulado;
+    if (Podar(coste)) return;
+    Entrada entrada;
+    entrada.coste = coste;
+    entrada.orden = siguiente_orden_++;
+    for (int x = index_hoja; x != -1; x = arbol[x].padre_idx) entrada.camino.push_back(arbol[x].id);
+    std::reverse(entrada.camino.begin(), entrada.camino.end());
+    if (monticulo_.size() == k_) {
+      std::pop_heap(monticulo_.begin(), monticulo_.end(), Antes);
+      monticulo_.pop_back();
+    }
+    monticulo_.push_back(std::move(entrada));
+    std::push_heap(monticulo_.begin(), monticulo_.end(), Antes);
+  }
+
+  // Pasa las soluciones al resultado, de menor a mayor coste; sin receptor, camino es
+  // la más barata (con receptor camino no se rellena, como en el resto de soluciones)
+  void Volcar(trace::ResultadoBusqueda& resultado, const ReceptorSoluciones& receptor) {
+    if (!Activo()) return;
+    std::sort_heap(monticulo_.begin(), monticulo_.end(), Antes);
+    resultado.mejores.clear();
+    for (auto& entrada : monticulo_) {
+      resultado.mejores.push_back({std::move(entrada.camino), entrada.coste});
+    }
+    monticulo_.clear();
+    if (!receptor && !resultado.mejores.empty()) {
+      resultado.camino = resultado.mejores.front().camino;
+      resultado.coste_total = resultado.mejores.front().coste;
+    }
+  }
+
+ private:
+  struct Entrada {
+    std::vector<int> camino;
+    double coste = 0.0;
+    size_t orden = 0;
+  };
+
+  static bool Antes(const Entrada& a, const Entrada& b) {
+    return a.coste < b.coste || (a.coste == b.coste && a.orden < b.orden);
+  }
+
+  size_t k_;
+  size_t siguiente_orden_ = 0;
+  std::vector<Entrada> monticulo_;
+};
+
+// Anota la solución que acaba en index_hoja. Sin receptor se guarda en resultado (y
+// sustituye a la anterior); con receptor se le entrega el camino, escrito en 'buffer'
+// (que se reutiliza entre soluciones), y resultado.camino no se toca. Con k_mejores
+// se guarda además entre las mejores (y el camino se elige al final, con Volcar).
+// Devuelve false si el receptor pide terminar la búsqueda.
+template <typename G>
+bool AnotarSolucion(const G& g, const ArenaArbol& arbol, int index_hoja,
+                    trace::ResultadoBusqueda& resultado, const ReceptorSoluciones& receptor,
+                    std::vector<int>& buffer, MejoresSoluciones& mejores) {
+  resultado.found = true;
+  if (mejores.Activo()) mejores.Anadir(arbol, index_hoja);
+  if (!receptor) {
+    if (!mejores.Activo()) ReconstruirSolucion(g, arbol, index_hoja, resultado);
+    return true;
+  }
+  buffer.clear();
+  for (int x = index_hoja; x != -1; x = arbol[x].padre_idx) buffer.push_back(arbol[x].id);
+  std::reverse(buffer.begin(), buffer.end());
+  return receptor(VistaSolucion{buffer.data(), buffer.size(), arbol[index_hoja].coste_acumulado});
+}
+
+template <typename G>
+trace::ResultadoBusqueda BfsImpl(const G& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                 MarcasVertice& generados, ArenaArbol& arbol, const ReceptorSoluciones& receptor,
+                                 std::vector<int>& buffer) {
   // Obtenemos el numero de vertices del grafo
   const int n = g.GetNumVertices();
 
@@ -27,9 +181,19 @@ trace::ResultadoBusqueda busqueda::Bfs(const Grafo& g, int origen, int destino,
     throw std::out_of_range("origen/destino fuera de rango");
   }
 
-  // Creamos un vector donde guardamos todos los nodos del árbol de busqueda
-  std::vector<NodoArbol> arbol;
-  arbol.push_back({origen, -1, 0.0, 0});  // Nodo raíz
+  // En búsqueda en grafo el origen cuenta ya como generado
+  const bool en_grafo = opts.busqueda_en_grafo;
+  if (en_grafo) {
+    generados.Reiniciar(n);
+    generados.Marcar(origen);
+  }
+
+  // Vaciamos el arena donde guardamos todos los nodos del árbol de busqueda
+  arbol.Reiniciar();
+  arbol.Anadir({origen, -1, 0.0, 0, BitFirma(origen)});  // Nodo raíz
+
+  // Las k soluciones más baratas, si se piden (también sirven para podar)
+  MejoresSoluciones mejores(opts.k_mejores);
 
   // Creamos una cola (frontera) donde vamos a ir almacenado los índices a arbol
   std::queue<int> frontera;
@@ -56,6 +220,7 @@ trace::ResultadoBusqueda busqueda::Bfs(const Grafo& g, int origen, int destino,
     const int index_actual = frontera.front();
     frontera.pop();
 
+    // Referencia: el arena no mueve los nodos al generar hijos
     const NodoArbol& nodo_actual = arbol[index_actual];
 
     registro.inspeccionados_delta.push_back(nodo_actual.id);
@@ -64,30 +229,13 @@ trace::ResultadoBusqueda busqueda::Bfs(const Grafo& g, int origen, int destino,
 
     if (nodo_actual.id == destino) {
 
-      resultado.found = true;
-
-      // Reconstrucción de camino usando pradre_idx
-      std::vector<int> camino_rev;
-      for (int x = index_actual; x != -1; x = arbol[x].padre_idx) {
-        camino_rev.push_back(arbol[x].id);
-      }
-
-      // Invertimos los valores de camino_rev
-      std::reverse(camino_rev.begin(),camino_rev.end());
-
-      // Añadimos el camino al resultado
-      resultado.camino = camino_rev;
-
-      resultado.coste_total = 0.0;
-
-      // Ahora hallamos el coste total
-      for (size_t i = 0; i + 1 < resultado.camino.size(); ++i) {
-        resultado.coste_total += g.GetPesoArista(resultado.camino[i], resultado.camino[i + 1]);
-      }
+      // Reconstrucción de camino usando pradre_idx, y su coste total (o se entrega al receptor)
+      const bool seguir = AnotarSolucion(g, arbol, index_actual, resultado, receptor, buffer, mejores);
 
       // Comprobamos si quiere que se detenga en la primera iteración
-      if (opts.parar_a_primera_solucion) {
+      if (opts.parar_a_primera_solucion || !seguir) {
         resultado.traza.push_back(registro);
+        mejores.Volcar(resultado, receptor);
         return resultado;
       } else {
         resultado.traza.push_back(registro);
@@ -97,7 +245,7 @@ trace::ResultadoBusqueda busqueda::Bfs(const Grafo& g, int origen, int destino,
 
     // Expandimos vecinos
     // Obtenemos los vecinos actuales
-    const auto& vecinos_actuales = g.GetVecinosPorId(arbol[index_actual].id);
+    const auto& vecinos_actuales = Vecinos(g, nodo_actual.id);
 
     // Añadimos los nuevos nodos generados al registro
     // for (size_t i = 0; i < vecinos_actuales.size(); ++i) {
@@ -107,16 +255,18 @@ trace::ResultadoBusqueda busqueda::Bfs(const Grafo& g, int origen, int destino,
       const int vecino_id = vecino.first;
       const double peso = vecino.second;
       
+      // Con k_mejores, no generamos ramas que ya no pueden mejorar la k-ésima solución
+      if (mejores.Podar(nodo_actual.coste_acumulado + peso)) continue;
+
       // Comprobamos que el vecino no este ya en el camino,
-      // asi evitamos cicls en el camino actual (tree-search)
-      if (EstaEnCamino(vecino_id, index_actual, arbol)) continue;
+      // asi evitamos cicls en el camino actual (tree-search), o que no se haya generado ya (graph-search)
+      if (DescartarVecino(vecino_id, index_actual, arbol, en_grafo, generados)) continue;
 
       // Generamos al hijo (hoja)
-      NodoArbol hijo{vecino_id, index_actual, nodo_actual.coste_acumulado + peso, nodo_actual.profundidad + 1};
-      arbol.push_back(hijo);
-      // Obtenemos el indice del hijo restandole al tamaño del arbol 1, ya que los hijos se van añadiendo
-      // entonces su tamaño aumenta
-      const int index_hijo = static_cast<int>(arbol.size()) - 1;
+      NodoArbol hijo{vecino_id, index_actual, nodo_actual.coste_acumulado + peso, nodo_actual.profundidad + 1,
+                     nodo_actual.firma | BitFirma(vecino_id)};
+      // Lo añadimos al arbol, que nos devuelve su índice
+      const int index_hijo = arbol.Anadir(hijo);
 
       // Añadimos el indice del hijo a la frontera
       frontera.push(index_hijo);
@@ -126,10 +276,14 @@ trace::ResultadoBusqueda busqueda::Bfs(const Grafo& g, int origen, int destino,
     }
     resultado.traza.push_back(registro);
   }
+  mejores.Volcar(resultado, receptor);
   return resultado;
 }
 
-trace::ResultadoBusqueda busqueda::Dfs(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts) {
+template <typename G>
+trace::ResultadoBusqueda DfsImpl(const G& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                 MarcasVertice& generados, MarcasVertice& en_camino, ArenaArbol& arbol,
+                                 const ReceptorSoluciones& receptor, std::vector<int>& buffer) {
   // Obtenemos el numero de vertices del grafo
   const int n = g.GetNumVertices();
 
@@ -137,19 +291,34 @@ trace::ResultadoBusqueda busqueda::Dfs(const Grafo& g, int origen, int destino,
     throw std::out_of_range("origen/destino fuera de rango");
   }
 
-  // Creamos el arbol
-  std::vector<NodoArbol> arbol;
-  arbol.push_back({origen, -1, 0.0, 0});
-
-  // Creamos la frontera, podemos usar una stack, pero yo prefiero usar un vector
-  std::vector<int> stack;
-  stack.push_back(0);
+  // En búsqueda en grafo el origen cuenta ya como generado
+  const bool en_grafo = opts.busqueda_en_grafo;
+  if (en_grafo) {
+    generados.Reiniciar(n);
+    generados.Marcar(origen);
+  }
 
-  // next_pos será un vector paralelo a 'arbol' y 'stack' que nos dice
-  // añun no he explorado ningun vecino de este nodo.
+  // La pila es siempre el camino actual desde la raíz, así que en búsqueda en árbol
+  // basta con marcar cada vértice al apilarlo y desmarcarlo al desapilarlo para
+  // comprobar los ciclos en O(1) (en vez de subir por padre_idx con EstaEnCamino)
+  en_camino.Reiniciar(n);
+  en_camino.Marcar(origen);
+
+  // Creamos el arbol. Funciona como pila: al retroceder desde un nodo ya no se vuelve
+  // a necesitar su subárbol, así que se quita del final. De esta forma 'arbol' es
+  // siempre el camino actual (el índice de cada nodo es su profundidad) y la memoria
+  // es O(profundidad) aunque se recorra el árbol entero.
+  arbol.Reiniciar();
+  arbol.Anadir({origen, -1, 0.0, 0});
+
+  // next_pos será un vector paralelo a 'arbol' que nos dice por qué vecino vamos
+  // de cada nodo del camino (0 = añun no he explorado ningun vecino de este nodo).
   std::vector<int> next_pos;
   next_pos.push_back(0);
 
+  // Las k soluciones más baratas, si se piden (también sirven para podar)
+  MejoresSoluciones mejores(opts.k_mejores);
+
   trace::ResultadoBusqueda resultado;
   int iteracion = 0;
 
@@ -161,14 +330,14 @@ trace::ResultadoBusqueda busqueda::Dfs(const Grafo& g, int origen, int destino,
   resultado.traza.push_back(registro0);
 
   
-  while (!stack.empty()) {
+  while (!arbol.Vacio()) {
     trace::RegistroIteracion registro;
 
     // Compactar backtracking: en esta iteración inspeccionamos tantos nodos "nuevos" como toquen
     // y generamos como máximo un hijo; si un nodo no puede generar, retrocede y sigue en el mismo paso.
     // bool genero_algo = false;
-    while (!stack.empty()) {
-      int index_actual = stack.back();
+    while (!arbol.Vacio()) {
+      int index_actual = static_cast<int>(arbol.Tamano()) - 1;
       const NodoArbol& nodo_actual = arbol[index_actual];
 
       // Inspeccionamos al entrar por primera vez
@@ -178,29 +347,22 @@ trace::ResultadoBusqueda busqueda::Dfs(const Grafo& g, int origen, int destino,
 
         // ¿Objetivo?
         if (nodo_actual.id == destino) {
-          resultado.found = true;
-
-          // Camino + coste
-          std::vector<int> camino_rev;
-          for (int x = index_actual; x != -1; x = arbol[x].padre_idx) camino_rev.push_back(arbol[x].id);
-          std::reverse(camino_rev.begin(), camino_rev.end());
-          resultado.camino = camino_rev;
-
-          resultado.coste_total = 0.0;
-          for (size_t i = 0; i + 1 < resultado.camino.size(); ++i) {
-            resultado.coste_total += g.GetPesoArista(resultado.camino[i], resultado.camino[i + 1]);
-          }
+          // Camino + coste (o se entrega al receptor)
+          const bool seguir = AnotarSolucion(g, arbol, index_actual, resultado, receptor, buffer, mejores);
 
           // Registrar y salir si hay que parar
           registro.paso = ++iteracion;
           resultado.traza.push_back(std::move(registro));
-          if (opts.parar_a_primera_solucion) return resultado;
+          if (opts.parar_a_primera_solucion || !seguir) {
+            mejores.Volcar(resultado, receptor);
+            return resultado;
+          }
           // Si no paramos, seguimos intentando expandir (como cualquier nodo)
         }
       }
 
       // Intentar generar exactamente un hijo desde este nodo
-      const auto& vecinos = g.GetVecinosPorId(nodo_actual.id);
+      const auto& vecinos = Vecinos(g, nodo_actual.id);
       int& pos = next_pos[index_actual];
 
       bool genero_hijo = false;
@@ -210,18 +372,24 @@ trace::ResultadoBusqueda busqueda::Dfs(const Grafo& g, int origen, int destino,
         double peso   = vecinos[pos].second;
         ++pos; // avanza el cursor
 
-        if (EstaEnCamino(vecino_id, index_actual, arbol)) continue;
+        // Rama que ya no puede mejorar la k-ésima solución (con k_mejores)
+        if (mejores.Podar(nodo_actual.coste_acumulado + peso)) continue;
+
+        if (en_grafo) {
+          if (DescartarVecino(vecino_id, index_actual, arbol, en_grafo, generados)) continue;
+        } else if (en_camino.Marcado(vecino_id)) {
+          continue;
+        }
 
         // Generar hijo y descender
         NodoArbol hijo{vecino_id, index_actual,
                        nodo_actual.coste_acumulado + peso,
                        nodo_actual.profundidad + 1};
-        arbol.push_back(hijo);
-        int index_hijo = static_cast<int>(arbol.size()) - 1;
+        arbol.Anadir(hijo);
 
-        // Se añade el hijo a next_pos y stack
+        // Se añade el hijo a next_pos
         next_pos.push_back(0);
-        stack.push_back(index_hijo);
+        en_camino.Marcar(vecino_id);
 
         registro.generados_delta.push_back(vecino_id);
         resultado.nodos_generados++;
@@ -235,9 +403,12 @@ trace::ResultadoBusqueda busqueda::Dfs(const Grafo& g, int origen, int destino,
         break; // cerramos la iteración con este generado
       }
 
-      // Si este nodo no puede generar más hijos, retrocedemos y seguimos en la misma iteración
+      // Si este nodo no puede generar más hijos, retrocedemos (y lo quitamos del árbol)
+      // y seguimos en la misma iteración
       if (pos >= static_cast<int>(vecinos.size())) {
-        stack.pop_back();
+        en_camino.Desmarcar(nodo_actual.id);
+        arbol.QuitarUltimo();
+        next_pos.pop_back();
         continue; // intentará el padre en este mismo paso
       }
 
@@ -255,20 +426,99 @@ trace::ResultadoBusqueda busqueda::Dfs(const Grafo& g, int origen, int destino,
       break;
     }
   }
+  mejores.Volcar(resultado, receptor);
   return resultado;
 }
 
-trace::ResultadoBusqueda busqueda::BfsModi(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts) {
+// Frontera de BfsModi: permite sacar tanto el nodo de menor coste acumulado como el
+// de mayor coste en O(log F). Son dos montículos sobre los mismos índices de 'arbol':
+//   - mínimos: (coste asc, índice asc)
+//   - máximos: (coste desc, índice asc)
+// En ambos extremos los empates se deshacen a favor del nodo generado antes (el de
+// menor índice), igual que la búsqueda lineal de la primera aparición sobre la
+// frontera en orden de inserción. Un nodo que sale por un montículo se marca como
+// fuera y el otro lo descarta cuando le llega a la cima (borrado perezoso).
+class FronteraDoble {
+ public:
+  explicit FronteraDoble(const ArenaArbol& arbol) : arbol_(arbol) {}
+
+  bool Vacia() const { return vivos_ == 0; }
+
+  void Insertar(int index) {
+    if (static_cast<size_t>(index) >= fuera_.size()) fuera_.resize(static_cast<size_t>(index) + 1, 0);
+    minimos_.push_back(index);
+    std::push_heap(minimos_.begin(), minimos_.end(), MenosPrioritarioMin{arbol_});
+    maximos_.push_back(index);
+    std::push_heap(maximos_.begin(), maximos_.end(), MenosPrioritarioMax{arbol_});
+    ++vivos_;
+  }
+
+  int SacarMejor() { return Sacar(minimos_, MenosPrioritarioMin{arbol_}); }
+  int SacarPeor() { return Sacar(maximos_, MenosPrioritarioMax{arbol_}); }
+
+ private:
+  // Comparadores para std::push_heap/pop_heap: devuelven true si a debe salir después que b
+  struct MenosPrioritarioMin {
+    const ArenaArbol& arbol;
+    bool operator()(int a, int b) const {
+      const double ca = arbol[a].coste_acumulado;
+      const double cb = arbol[b].coste_acumulado;
+      return ca > cb || (ca == cb && a > b);
+    }
+  };
+  struct MenosPrioritarioMax {
+    const ArenaArbol& arbol;
+    bool operator()(int a, int b) const {
+      const double ca = arbol[a].coste_acumulado;
+      const double cb = arbol[b].coste_acumulado;
+      return ca < cb || (ca == cb && a > b);
+    }
+  };
+
+  template <typename Comp>
+  int Sacar(std::vector<int>& monticulo, Comp comp) {
+    while (true) {
+      std::pop_heap(monticulo.begin(), monticulo.end(), comp);
+      const int index = monticulo.back();
+      monticulo.pop_back();
+      if (fuera_[index]) continue;  // ya salió por el otro extremo
+      fuera_[index] = 1;
+      --vivos_;
+      return index;
+    }
+  }
+
+  const ArenaArbol& arbol_;
+  std::vector<int> minimos_;
+  std::vector<int> maximos_;
+  std::vector<char> fuera_;  ///< fuera_[i] = 1 si el nodo i ya salió de la frontera.
+  size_t vivos_ = 0;         ///< Nodos que siguen en la frontera.
+};
+
+template <typename G>
+trace::ResultadoBusqueda BfsModiImpl(const G& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                     MarcasVertice& generados, ArenaArbol& arbol,
+                                     const ReceptorSoluciones& receptor, std::vector<int>& buffer) {
   const int n = g.GetNumVertices();
   if (origen < 1 || origen > n || destino < 1 || destino > n) {
     throw std::out_of_range("origen/destino fuera de rango");
   }
 
-  std::vector<NodoArbol> arbol;
-  arbol.push_back({origen, -1, 0.0, 0});   // raíz
+  // En búsqueda en grafo el origen cuenta ya como generado
+  const bool en_grafo = opts.busqueda_en_grafo;
+  if (en_grafo) {
+    generados.Reiniciar(n);
+    generados.Marcar(origen);
+  }
+
+  arbol.Reiniciar();
+  arbol.Anadir({origen, -1, 0.0, 0, BitFirma(origen)});   // raíz
+
+  FronteraDoble frontera(arbol);
+  frontera.Insertar(0);
 
-  std::vector<int> frontera;
-  frontera.push_back(0);
+  // Las k soluciones más baratas, si se piden (también sirven para podar)
+  MejoresSoluciones mejores(opts.k_mejores);
 
   trace::ResultadoBusqueda resultado;
   int iteracion = 0;
@@ -279,35 +529,17 @@ trace::ResultadoBusqueda busqueda::BfsModi(const Grafo& g, int origen, int desti
   resultado.nodos_generados++;
   resultado.traza.push_back(std::move(reg0));
 
-  while (!frontera.empty()) {
+  while (!frontera.Vacia()) {
     trace::RegistroIteracion reg;
     reg.paso = ++iteracion;
 
-    // Calculamos el mejor (min coste) y peor (max coste) de la frontera
-    // Guardamos los indices
-    int pos_min = 0;
-    int pos_max = 0;
-    // cmin es el coste acumulado del nodo en la posición pos_min
-    double cmin = arbol[frontera[0]].coste_acumulado;
-    // cmax es el coste acumulado del nodo en la posición pos_max
-    double cmax = cmin;
-    for (int i = 1; i < static_cast<int>(frontera.size()); ++i) {
-      const double c = arbol[frontera[i]].coste_acumulado;
-      if (c < cmin) { cmin = c; pos_min = i; }
-      if (c > cmax) { cmax = c; pos_max = i; }
-    }
-
-    // Aletariedad de manera casera: impar => mejor, par => peor 
+    // Aletariedad de manera casera: impar => mejor (min coste), par => peor (max coste)
     const bool elegir_peor = (reg.paso % 2 == 0);
-    const int pos_elegida = elegir_peor ? pos_max : pos_min;
-
 
     // sacamos ese índice de la frontera para inspección
-    const int index_actual = frontera[pos_elegida];
-    // Eliminiamos el pos_elegida con erase de la frontera
-    // comenzamos desde el inicio + pos_eleigida llegamos a la posicion 
-    frontera.erase(frontera.begin() + pos_elegida);
+    const int index_actual = elegir_peor ? frontera.SacarPeor() : frontera.SacarMejor();
 
+    // Referencia: el arena no mueve los nodos al generar hijos
     const NodoArbol& nodo_actual = arbol[index_actual];
 
     // inspeccionados (delta)
@@ -316,37 +548,113 @@ trace::ResultadoBusqueda busqueda::BfsModi(const Grafo& g, int origen, int desti
 
     // ¿Objetivo?
     if (nodo_actual.id == destino) {
-      // reconstruimos el camino
-      std::vector<int> camino_rev;
-      for (int x = index_actual; x != -1; x = arbol[x].padre_idx) camino_rev.push_back(arbol[x].id);
-      std::reverse(camino_rev.begin(), camino_rev.end());
-      resultado.camino = camino_rev;
-
-      // coste total
-      resultado.coste_total = 0.0;
-      for (size_t i = 0; i + 1 < resultado.camino.size(); ++i) {
-        resultado.coste_total += g.GetPesoArista(resultado.camino[i], resultado.camino[i + 1]);
-      }
+      // reconstruimos el camino y su coste total (o se entrega al receptor)
+      const bool seguir = AnotarSolucion(g, arbol, index_actual, resultado, receptor, buffer, mejores);
 
-      resultado.found = true;
       resultado.traza.push_back(std::move(reg));
-      if (opts.parar_a_primera_solucion) return resultado;
+      if (opts.parar_a_primera_solucion || !seguir) {
+        mejores.Volcar(resultado, receptor);
+        return resultado;
+      }
     }
 
     // añadimos Todos los vecinos a la frontera
-    const auto& vecinos = g.GetVecinosPorId(nodo_actual.id);
+    const auto& vecinos = Vecinos(g, nodo_actual.id);
     for (const auto& vecino : vecinos) {
       const int vecino_id = vecino.first;
       const double peso = vecino.second;
 
+      // Rama que ya no puede mejorar la k-ésima solución (con k_mejores)
+      if (mejores.Podar(nodo_actual.coste_acumulado + peso)) continue;
+
       // Evitamos ciclo en el camino
-      if (EstaEnCamino(vecino_id, index_actual, arbol)) continue;
+      if (DescartarVecino(vecino_id, index_actual, arbol, en_grafo, generados)) continue;
+
+      NodoArbol hijo{vecino_id, index_actual, nodo_actual.coste_acumulado + peso, nodo_actual.profundidad + 1,
+                     nodo_actual.firma | BitFirma(vecino_id)};
+      const int idx_hijo = arbol.Anadir(hijo);
+
+      frontera.Insertar(idx_hijo);
+      reg.generados_delta.push_back(vecino_id);
+      resultado.nodos_generados++;
+    }
+
+    resultado.traza.push_back(std::move(reg));
+  }
+
+  mejores.Volcar(resultado, receptor);
+  return resultado;
+}
+
+template <typename G>
+trace::ResultadoBusqueda UcsImpl(const G& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                 MarcasVertice& generados, MarcasVertice& cerrados,
+                                 std::vector<double>& mejor_coste, MonticuloRadix<int>& frontera,
+                                 ArenaArbol& arbol) {
+  const int n = g.GetNumVertices();
+  if (origen < 1 || origen > n || destino < 1 || destino > n) {
+    throw std::out_of_range("origen/destino fuera de rango");
+  }
+
+  // UCS es siempre búsqueda en grafo: 'generados' indica qué vértices tienen ya un
+  // coste provisional en mejor_coste y 'cerrados' cuáles se han inspeccionado (su
+  // coste ya es el óptimo). Ambos se vacían en O(1) y mejor_coste no hace falta
+  // inicializarlo, porque solo se lee si el vértice está en 'generados'.
+  generados.Reiniciar(n);
+  cerrados.Reiniciar(n);
+  if (mejor_coste.size() < static_cast<size_t>(n) + 1) mejor_coste.resize(static_cast<size_t>(n) + 1);
+  frontera.Vaciar();
+
+  arbol.Reiniciar();
+  arbol.Anadir({origen, -1, 0.0, 0});   // raíz
+  generados.Marcar(origen);
+  mejor_coste[origen] = 0.0;
+  frontera.Insertar(0.0, 0);
+
+  trace::ResultadoBusqueda resultado;
+  int iteracion = 0;
+
+  trace::RegistroIteracion reg0;
+  reg0.paso = ++iteracion;
+  reg0.generados_delta.push_back(origen);
+  resultado.nodos_generados++;
+  resultado.traza.push_back(std::move(reg0));
+
+  while (!frontera.Vacio()) {
+    const int index_actual = frontera.SacarMinimo().second;
+
+    // Referencia: el arena no mueve los nodos al generar hijos
+    const NodoArbol& nodo_actual = arbol[index_actual];
+
+    // Borrado perezoso: si el vértice ya se cerró con un coste menor, esta entrada
+    // de la frontera está obsoleta y no cuenta como iteración
+    if (cerrados.Marcado(nodo_actual.id)) continue;
+    cerrados.Marcar(nodo_actual.id);
+
+    trace::RegistroIteracion reg;
+    reg.paso = ++iteracion;
+    reg.inspeccionados_delta.push_back(nodo_actual.id);
+    resultado.nodos_inspeccionados++;
 
-      NodoArbol hijo{vecino_id, index_actual, nodo_actual.coste_acumulado + peso, nodo_actual.profundidad + 1};
-      arbol.push_back(hijo);
-      const int idx_hijo = static_cast<int>(arbol.size()) - 1;
+    if (nodo_actual.id == destino) {
+      resultado.found = true;
+      ReconstruirSolucion(g, arbol, index_actual, resultado);
+      resultado.traza.push_back(std::move(reg));
+      if (opts.parar_a_primera_solucion) return resultado;
+      continue;
+    }
+
+    for (const auto& vecino : Vecinos(g, nodo_actual.id)) {
+      const int vecino_id = vecino.first;
+      const double coste = nodo_actual.coste_acumulado + vecino.second;
 
-      frontera.push_back(idx_hijo);
+      // Solo generamos si mejora el mejor coste conocido para ese vértice
+      if (cerrados.Marcado(vecino_id)) continue;
+      if (generados.Marcado(vecino_id) && coste >= mejor_coste[vecino_id]) continue;
+      generados.Marcar(vecino_id);
+      mejor_coste[vecino_id] = coste;
+
+      frontera.Insertar(coste, arbol.Anadir({vecino_id, index_actual, coste, nodo_actual.profundidad + 1}));
       reg.generados_delta.push_back(vecino_id);
       resultado.nodos_generados++;
     }
@@ -355,4 +663,1078 @@ trace::ResultadoBusqueda busqueda::BfsModi(const Grafo& g, int origen, int desti
   }
 
   return resultado;
-}
\ No newline at end of file
+}
+
+// Prepara un lado de la BFS bidireccional con su extremo como único vértice alcanzado
+void IniciarLado(LadoBidireccional& lado, int n, int extremo) {
+  lado.visitados.Reiniciar(n);
+  if (lado.padre.size() < static_cast<size_t>(n) + 1) {
+    lado.padre.resize(static_cast<size_t>(n) + 1);
+    lado.nivel.resize(static_cast<size_t>(n) + 1);
+  }
+  lado.visitados.Marcar(extremo);
+  lado.padre[extremo] = -1;
+  lado.nivel[extremo] = 0;
+  lado.frontera.clear();
+  lado.frontera.push_back(extremo);
+}
+
+template <typename G>
+trace::ResultadoBusqueda BfsBidireccionalImpl(const G& g, int origen, int destino,
+                                              LadoBidireccional& lado_origen, LadoBidireccional& lado_destino) {
+  const int n = g.GetNumVertices();
+  if (origen < 1 || origen > n || destino < 1 || destino > n) {
+    throw std::out_of_range("origen/destino fuera de rango");
+  }
+
+  IniciarLado(lado_origen, n, origen);
+  IniciarLado(lado_destino, n, destino);
+
+  trace::ResultadoBusqueda resultado;
+  int iteracion = 0;
+
+  // Iteración 1: se generan los dos extremos
+  trace::RegistroIteracion reg0;
+  reg0.paso = ++iteracion;
+  reg0.generados_delta.push_back(origen);
+  resultado.nodos_generados++;
+  if (destino != origen) {
+    reg0.generados_delta.push_back(destino);
+    resultado.nodos_generados++;
+  }
+  resultado.traza.push_back(std::move(reg0));
+
+  // Mejor encuentro: arista (desde_origen, desde_destino) que une los dos lados
+  int mejor_longitud = -1;
+  int desde_origen = -1;
+  int desde_destino = -1;
+  if (origen == destino) {
+    mejor_longitud = 0;
+    desde_origen = desde_destino = origen;
+  }
+
+  std::vector<int> siguiente;
+  while (mejor_longitud < 0 && !lado_origen.frontera.empty() && !lado_destino.frontera.empty()) {
+    // Expandimos el lado con menos vértices en la frontera
+    const bool expandir_origen = lado_origen.frontera.size() <= lado_destino.frontera.size();
+    LadoBidireccional& lado = expandir_origen ? lado_origen : lado_destino;
+    const LadoBidireccional& otro = expandir_origen ? lado_destino : lado_origen;
+
+    trace::RegistroIteracion reg;
+    reg.paso = ++iteracion;
+    siguiente.clear();
+
+    // Se expande el nivel entero aunque haya encuentro a mitad: otro vértice del mismo
+    // nivel puede tocar al otro lado más cerca de su extremo
+    for (const int u : lado.frontera) {
+      reg.inspeccionados_delta.push_back(u);
+      resultado.nodos_inspeccionados++;
+
+      for (const auto& vecino : Vecinos(g, u)) {
+        const int v = vecino.first;
+        if (otro.visitados.Marcado(v)) {
+          const int longitud = lado.nivel[u] + 1 + otro.nivel[v];
+          if (mejor_longitud < 0 || longitud < mejor_longitud) {
+            mejor_longitud = longitud;
+            desde_origen = expandir_origen ? u : v;
+            desde_destino = expandir_origen ? v : u;
+          }
+        }
+        if (lado.visitados.Marcado(v)) continue;
+        lado.visitados.Marcar(v);
+        lado.padre[v] = u;
+        lado.nivel[v] = lado.nivel[u] + 1;
+        siguiente.push_back(v);
+        reg.generados_delta.push_back(v);
+        resultado.nodos_generados++;
+      }
+    }
+    lado.frontera.swap(siguiente);
+    resultado.traza.push_back(std::move(reg));
+  }
+
+  if (mejor_longitud < 0) return resultado;
+
+  // Camino: origen ... desde_origen (subiendo por el lado del origen y dándole la vuelta)
+  // y después desde_destino ... destino (subiendo por el lado del destino)
+  resultado.found = true;
+  for (int x = desde_origen; x != -1; x = lado_origen.padre[x]) resultado.camino.push_back(x);
+  std::reverse(resultado.camino.begin(), resultado.camino.end());
+  if (desde_destino != desde_origen) {
+    for (int x = desde_destino; x != -1; x = lado_destino.padre[x]) resultado.camino.push_back(x);
+  }
+
+  resultado.coste_total = 0.0;
+  for (size_t i = 0; i + 1 < resultado.camino.size(); ++i) {
+    resultado.coste_total += g.GetPesoArista(resultado.camino[i], resultado.camino[i + 1]);
+  }
+  return resultado;
+}
+
+template <typename G>
+trace::ResultadoBusqueda IddfsImpl(const G& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                   MarcasVertice& en_camino) {
+  const int n = g.GetNumVertices();
+  if (origen < 1 || origen > n || destino < 1 || destino > n) {
+    throw std::out_of_range("origen/destino fuera de rango");
+  }
+
+  trace::ResultadoBusqueda resultado;
+
+  // Solo se guarda el camino actual y, por cada nivel, la posición del siguiente
+  // vecino a probar: la memoria es O(profundidad), no O(nodos generados)
+  std::vector<int> camino;
+  std::vector<int> cursor;
+
+  // Un camino simple tiene como mucho n - 1 aristas, así que ese es el límite máximo
+  for (int limite = 0; limite < n; ++limite) {
+    trace::RegistroIteracion registro;
+    registro.paso = limite + 1;
+
+    // cortado = algún nodo del límite tenía hijos que no se han podido generar;
+    // si no pasa, el árbol completo cabe en este límite y no hace falta seguir
+    bool cortado = false;
+    bool recien_llegado = true;
+
+    en_camino.Reiniciar(n);
+    camino.assign(1, origen);
+    cursor.assign(1, 0);
+    en_camino.Marcar(origen);
+    registro.generados_delta.push_back(origen);
+    resultado.nodos_generados++;
+
+    while (!camino.empty()) {
+      const int u = camino.back();
+      const int profundidad = static_cast<int>(camino.size()) - 1;
+      const auto& vecinos = Vecinos(g, u);
+
+      // Inspeccionamos al llegar al nodo; en el destino o en el límite no se expande
+      if (recien_llegado) {
+        recien_llegado = false;
+        registro.inspeccionados_delta.push_back(u);
+        resultado.nodos_inspeccionados++;
+
+        bool expandir = true;
+        if (u == destino) {
+          resultado.found = true;
+          resultado.camino = camino;
+          resultado.coste_total = 0.0;
+          for (size_t i = 0; i + 1 < camino.size(); ++i) {
+            resultado.coste_total += g.GetPesoArista(camino[i], camino[i + 1]);
+          }
+          if (opts.parar_a_primera_solucion) {
+            resultado.traza.push_back(std::move(registro));
+            return resultado;
+          }
+          expandir = false;
+        } else if (profundidad == limite) {
+          for (const auto& vecino : vecinos) {
+            if (!en_camino.Marcado(vecino.first)) {
+              cortado = true;
+              break;
+            }
+          }
+          expandir = false;
+        }
+
+        if (!expandir) {
+          en_camino.Desmarcar(u);
+          camino.pop_back();
+          cursor.pop_back();
+          continue;
+        }
+      }
+
+      // Generamos el siguiente hijo de u que no esté en el camino y bajamos a él
+      int& pos = cursor.back();
+      bool genero_hijo = false;
+      while (pos < static_cast<int>(vecinos.size())) {
+        const int vecino_id = vecinos[pos].first;
+        ++pos;
+        if (en_camino.Marcado(vecino_id)) continue;
+
+        en_camino.Marcar(vecino_id);
+        camino.push_back(vecino_id);
+        cursor.push_back(0);
+        registro.generados_delta.push_back(vecino_id);
+        resultado.nodos_generados++;
+        genero_hijo = true;
+        recien_llegado = true;
+        break;
+      }
+
+      // Sin más hijos: retrocedemos
+      if (!genero_hijo) {
+        en_camino.Desmarcar(u);
+        camino.pop_back();
+        cursor.pop_back();
+      }
+    }
+
+    resultado.traza.push_back(std::move(registro));
+    if (resultado.found || !cortado) break;
+  }
+
+  return resultado;
+}
+
+template <typename G>
+trace::ArbolCaminos BfsTodosImpl(const G& g, int origen) {
+  const int n = g.GetNumVertices();
+  if (origen < 1 || origen > n) {
+    throw std::out_of_range("origen fuera de rango");
+  }
+
+  trace::ArbolCaminos caminos;
+  caminos.origen = origen;
+  caminos.padre.assign(static_cast<size_t>(n) + 1, 0);
+  caminos.coste.assign(static_cast<size_t>(n) + 1, 0.0);
+
+  // padre != 0 indica que el vértice ya se generó (búsqueda en grafo), así que no
+  // hace falta otro conjunto de visitados. La cola es un vector con un índice de
+  // lectura porque cada vértice entra una sola vez.
+  std::vector<int> cola;
+  cola.reserve(static_cast<size_t>(n));
+  cola.push_back(origen);
+  caminos.padre[origen] = -1;
+
+  int iteracion = 0;
+  trace::RegistroIteracion registro0;
+  registro0.paso = ++iteracion;
+  registro0.generados_delta.push_back(origen);
+  caminos.nodos_generados++;
+  caminos.traza.push_back(std::move(registro0));
+
+  for (size_t cabeza = 0; cabeza < cola.size(); ++cabeza) {
+    const int u = cola[cabeza];
+
+    trace::RegistroIteracion registro;
+    registro.paso = ++iteracion;
+    registro.inspeccionados_delta.push_back(u);
+    caminos.nodos_inspeccionados++;
+
+    for (const auto& vecino : Vecinos(g, u)) {
+      const int v = vecino.first;
+      if (caminos.padre[v] != 0) continue;
+      caminos.padre[v] = u;
+      caminos.coste[v] = caminos.coste[u] + vecino.second;
+      cola.push_back(v);
+      registro.generados_delta.push_back(v);
+      caminos.nodos_generados++;
+    }
+    caminos.traza.push_back(std::move(registro));
+  }
+  return caminos;
+}
+
+// Número de hilos a usar (0 = los que tenga la máquina)
+int HilosEfectivos(int hilos) {
+  if (hilos == 0) return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  if (hilos < 1) throw std::invalid_argument("El número de hilos no puede ser < 0");
+  return hilos;
+}
+
+// Equipo de hilos que vive toda una búsqueda. Ejecutar(total, fn) reparte [0, total)
+// en trozos contiguos y llama a fn(ini, fin, t) en paralelo (el trozo 0 lo hace el hilo
+// llamador); vuelve cuando han terminado todos, así que hace de barrera entre niveles.
+// Los trabajadores se arrancan una sola vez y esperan cada ronda dormidos: crear y unir
+// hilos en cada nivel domina el tiempo en grafos de mucho diámetro (rejillas, carreteras).
+class EquipoHilos {
+ public:
+  using Trozo = std::function<void(size_t, size_t, size_t)>;
+
+  explicit EquipoHilos(int hilos) : hilos_(static_cast<size_t>(hilos)) {
+    trabajadores_.reserve(hilos_ - 1);
+    for (size_t t = 1; t < hilos_; ++t) trabajadores_.emplace_back([this, t] { Trabajar(t); });
+  }
+
+  ~EquipoHilos() {
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      salir_ = true;
+    }
+    hay_ronda_.notify_all();
+    for (auto& hilo : trabajadores_) hilo.join();
+  }
+
+  EquipoHilos(const EquipoHilos&) = delete;
+  EquipoHilos& operator=(const EquipoHilos&) = delete;
+
+  void Ejecutar(size_t total, const Trozo& fn) {
+    const size_t num = std::max<size_t>(1, std::min(hilos_, total));
+    if (num > 1) {
+      {
+        std::lock_guard<std::mutex> lock(m_);
+        fn_ = &fn;
+        total_ = total;
+        num_ = num;
+        pendientes_ = num - 1;
+        ++ronda_;
+      }
+      hay_ronda_.notify_all();
+    }
+    fn(size_t{0}, total / num, size_t{0});
+    if (num > 1) {
+      std::unique_lock<std::mutex> lock(m_);
+      ronda_terminada_.wait(lock, [&] { return pendientes_ == 0; });
+    }
+  }
+
+ private:
+  void Trabajar(size_t t) {
+    std::uint64_t vista = 0;
+    std::unique_lock<std::mutex> lock(m_);
+    while (true) {
+      hay_ronda_.wait(lock, [&] { return salir_ || ronda_ != vista; });
+      if (salir_) return;
+      vista = ronda_;
+      // En las rondas con menos trozos que hilos, los que sobran no hacen nada
+      if (t >= num_) continue;
+      const Trozo* fn = fn_;
+      const size_t total = total_;
+      const size_t num = num_;
+      lock.unlock();
+      (*fn)(total * t / num, total * (t + 1) / num, t);
+      lock.lock();
+      if (--pendientes_ == 0) ronda_terminada_.notify_one();
+    }
+  }
+
+  size_t hilos_;
+  std::vector<std::thread> trabajadores_;
+  std::mutex m_;
+  std::condition_variable hay_ronda_;
+  std::condition_variable ronda_terminada_;
+  const Trozo* fn_ = nullptr;   // protegidos por m_
+  size_t total_ = 0;
+  size_t num_ = 1;
+  size_t pendientes_ = 0;
+  std::uint64_t ronda_ = 0;
+  bool salir_ = false;
+};
+
+// Número de entradas de adyacencia (2 * aristas). GrafoCsr lo guarda; Grafo no, así
+// que allí hay que sumar los grados
+std::uint64_t NumEntradas(const Grafo& g) {
+  std::uint64_t entradas = 0;
+  for (int v = 1; v <= g.GetNumVertices(); ++v) entradas += Vecinos(g, v).size();
+  return entradas;
+}
+
+std::uint64_t NumEntradas(const GrafoCsr& g) {
+  return g.GetNumEntradas();
+}
+
+constexpr int kSinPadre = std::numeric_limits<int>::max();
+
+// Prepara el estado de BfsParalelo para n vértices. pos_padre y pos_en_frontera
+// ya están a kSinPadre salvo que crezcan o que la búsqueda anterior se cortara
+void IniciarBfsParalelo(EstadoBfsParalelo& estado, int n, int hilos) {
+  const size_t tamano = static_cast<size_t>(n) + 1;
+  estado.visitados.Reiniciar(n);
+  if (estado.padre.size() < tamano) estado.padre.resize(tamano);
+  if (estado.pos_padre.size() < tamano) {
+    // Un vector de atómicos no se puede redimensionar (no se mueven): se crea de nuevo
+    estado.pos_padre = std::vector<std::atomic<int>>(tamano);
+    estado.a_medias = true;
+  }
+  if (estado.a_medias) {
+    for (auto& p : estado.pos_padre) p.store(kSinPadre, std::memory_order_relaxed);
+    estado.pos_en_frontera.assign(estado.pos_padre.size(), kSinPadre);
+  }
+  if (estado.nuevos_por_hilo.size() < static_cast<size_t>(hilos)) {
+    estado.nuevos_por_hilo.resize(static_cast<size_t>(hilos));
+  }
+  estado.frontera.clear();
+  estado.siguiente.clear();
+  estado.a_medias = true;
+}
+
+template <typename G>
+trace::ResultadoBusqueda BfsParaleloImpl(const G& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                         int hilos, EstadoBfsParalelo& estado) {
+  const int n = g.GetNumVertices();
+  if (origen < 1 || origen > n || destino < 1 || destino > n) {
+    throw std::out_of_range("origen/destino fuera de rango");
+  }
+  hilos = HilosEfectivos(hilos);
+
+  // Umbrales de cambio de dirección (Beamer et al.): se pasa a ascendente cuando las
+  // aristas de la frontera superan a las de los no visitados / kAlfa, y se vuelve a
+  // descendente cuando la frontera baja de n / kBeta vértices
+  constexpr double kAlfa = 14.0;
+  constexpr double kBeta = 24.0;
+
+  IniciarBfsParalelo(estado, n, hilos);
+  // visitados/padre: vértices generados y desde cuál (-1 en el origen).
+  // pos_padre: durante un nivel, posición en la frontera del padre candidato de cada
+  // vértice nuevo (se queda la mínima, que es el padre que elegiría la BFS secuencial).
+  // pos_en_frontera: posición de cada vértice en la frontera actual (kSinPadre si no
+  // está o no se expande)
+  MarcasVertice& visitados = estado.visitados;
+  std::vector<int>& padre = estado.padre;
+  std::vector<std::atomic<int>>& pos_padre = estado.pos_padre;
+  std::vector<int>& pos_en_frontera = estado.pos_en_frontera;
+  std::vector<int>& frontera = estado.frontera;
+  std::vector<int>& siguiente = estado.siguiente;
+  std::vector<std::vector<int>>& nuevos_por_hilo = estado.nuevos_por_hilo;
+
+  trace::ResultadoBusqueda resultado;
+  int iteracion = 0;
+
+  trace::RegistroIteracion registro0;
+  registro0.paso = ++iteracion;
+  registro0.generados_delta.push_back(origen);
+  resultado.nodos_generados++;
+  resultado.traza.push_back(std::move(registro0));
+
+  visitados.Marcar(origen);
+  padre[origen] = -1;
+  frontera.push_back(origen);
+
+  // Aristas que salen de vértices aún no visitados (para decidir la dirección)
+  double aristas_sin_visitar = static_cast<double>(NumEntradas(g));
+  aristas_sin_visitar -= static_cast<double>(Vecinos(g, origen).size());
+  bool ascendente = false;
+
+  // Los hilos se arrancan una vez por búsqueda y cada nivel es una ronda del equipo
+  EquipoHilos equipo(hilos);
+
+  // Descendente: cada hilo expande un trozo de la frontera y reclama los vecinos no
+  // visitados con un mínimo atómico sobre la posición del padre
+  const EquipoHilos::Trozo expandir_descendente = [&](size_t ini, size_t fin, size_t t) {
+    std::vector<int>& nuevos = nuevos_por_hilo[t];
+    for (size_t i = ini; i < fin; ++i) {
+      const int u = frontera[i];
+      if (pos_en_frontera[u] == kSinPadre) continue;
+      const int pos = static_cast<int>(i);
+      for (const auto& vecino : Vecinos(g, u)) {
+        const int v = vecino.first;
+        if (visitados.Marcado(v)) continue;
+        int actual = pos_padre[v].load(std::memory_order_relaxed);
+        while (pos < actual && !pos_padre[v].compare_exchange_weak(actual, pos, std::memory_order_relaxed)) {
+        }
+        // Solo quien lo saca de kSinPadre lo apunta, así cada vértice nuevo sale una vez
+        if (actual == kSinPadre) nuevos.push_back(v);
+      }
+    }
+  };
+  // Ascendente: cada hilo recorre un trozo de los vértices no visitados y busca, entre
+  // sus vecinos, el que está antes en la frontera (no hay escrituras compartidas)
+  const EquipoHilos::Trozo expandir_ascendente = [&](size_t ini, size_t fin, size_t t) {
+    std::vector<int>& nuevos = nuevos_por_hilo[t];
+    for (size_t k = ini; k < fin; ++k) {
+      const int v = static_cast<int>(k) + 1;
+      if (visitados.Marcado(v)) continue;
+      int mejor = kSinPadre;
+      for (const auto& vecino : Vecinos(g, v)) {
+        mejor = std::min(mejor, pos_en_frontera[vecino.first]);
+      }
+      if (mejor != kSinPadre) {
+        pos_padre[v].store(mejor, std::memory_order_relaxed);
+        nuevos.push_back(v);
+      }
+    }
+  };
+
+  while (!frontera.empty()) {
+    trace::RegistroIteracion registro;
+    registro.paso = ++iteracion;
+
+    // La BFS secuencial inspecciona la frontera en orden y, si llega al destino, para
+    // ahí (o no lo expande si sigue). Reproducimos eso: se inspecciona hasta el destino
+    // y solo se expanden los vértices anteriores a él.
+    size_t inspeccionar = frontera.size();
+    bool parar = false;
+    const auto it_destino = std::find(frontera.begin(), frontera.end(), destino);
+    if (it_destino != frontera.end()) {
+      if (opts.parar_a_primera_solucion) {
+        inspeccionar = static_cast<size_t>(it_destino - frontera.begin()) + 1;
+        parar = true;
+      }
+    }
+    registro.inspeccionados_delta.assign(frontera.begin(), frontera.begin() + static_cast<long>(inspeccionar));
+    resultado.nodos_inspeccionados += inspeccionar;
+
+    // Posiciones de los vértices que se expanden (todos los inspeccionados menos el destino)
+    double aristas_frontera = 0.0;
+    for (size_t i = 0; i < inspeccionar; ++i) {
+      if (frontera[i] == destino) continue;
+      pos_en_frontera[frontera[i]] = static_cast<int>(i);
+      aristas_frontera += static_cast<double>(Vecinos(g, frontera[i]).size());
+    }
+
+    if (!ascendente && aristas_frontera > aristas_sin_visitar / kAlfa) ascendente = true;
+    else if (ascendente && static_cast<double>(frontera.size()) < n / kBeta) ascendente = false;
+
+    for (auto& nuevos : nuevos_por_hilo) nuevos.clear();
+    if (!ascendente) equipo.Ejecutar(inspeccionar, expandir_descendente);
+    else equipo.Ejecutar(static_cast<size_t>(n), expandir_ascendente);
+
+    // Orden de la BFS secuencial: por posición del padre en la frontera y, dentro de
+    // cada padre, por id (las listas de vecinos están ordenadas)
+    siguiente.clear();
+    for (const auto& nuevos : nuevos_por_hilo) siguiente.insert(siguiente.end(), nuevos.begin(), nuevos.end());
+    std::sort(siguiente.begin(), siguiente.end(), [&](int a, int b) {
+      const int pa = pos_padre[a].load(std::memory_order_relaxed);
+      const int pb = pos_padre[b].load(std::memory_order_relaxed);
+      return pa < pb || (pa == pb && a < b);
+    });
+    for (const int v : siguiente) {
+      visitados.Marcar(v);
+      padre[v] = frontera[static_cast<size_t>(pos_padre[v].load(std::memory_order_relaxed))];
+      pos_padre[v].store(kSinPadre, std::memory_order_relaxed);
+      aristas_sin_visitar -= static_cast<double>(Vecinos(g, v).size());
+    }
+    for (size_t i = 0; i < inspeccionar; ++i) pos_en_frontera[frontera[i]] = kSinPadre;
+
+    registro.generados_delta = siguiente;
+    resultado.nodos_generados += siguiente.size();
+    resultado.traza.push_back(std::move(registro));
+
+    if (it_destino != frontera.end()) {
+      resultado.found = true;
+      for (int x = destino; x != -1; x = padre[x]) resultado.camino.push_back(x);
+      std::reverse(resultado.camino.begin(), resultado.camino.end());
+      resultado.coste_total = 0.0;
+      for (size_t i = 0; i + 1 < resultado.camino.size(); ++i) {
+        resultado.coste_total += g.GetPesoArista(resultado.camino[i], resultado.camino[i + 1]);
+      }
+      if (parar) break;
+    }
+    frontera.swap(siguiente);
+  }
+  estado.a_medias = false;
+  return resultado;
+}
+
+// Trabajo pendiente de DfsParalelo: los hijos del último vértice de 'camino' a partir de
+// la posición 'pos' de su lista de vecinos (hermanos aún sin explorar). Si
+// 'inspeccionar' es true, ese vértice tampoco se ha inspeccionado (tarea del origen).
+struct TareaDfs {
+  std::vector<int> camino;
+  int pos = 0;
+  bool inspeccionar = false;
+};
+
+// Estado de cada hilo de DfsParalelo: su deque de tareas (el dueño saca por el final,
+// los ladrones por el principio, donde están los subárboles más altos) y sus contadores.
+// num_tareas es una pista del tamaño de la deque que se lee sin el mutex, para no
+// bloquear deques vacías (se actualiza con el mutex tomado).
+struct TrabajadorDfs {
+  std::mutex m;
+  std::deque<TareaDfs> tareas;
+  std::atomic<size_t> num_tareas{0};
+  size_t generados = 0;
+  size_t inspeccionados = 0;
+  std::vector<int> ultima_solucion;
+};
+
+// Indica si el camino a sale después que b en el recorrido secuencial de Dfs (ambos
+// desde el mismo origen y sin ser uno prefijo del otro): decide el primer vértice en
+// que difieren, según su posición en la lista de vecinos del vértice anterior
+template <typename G>
+bool SaleDespuesEnDfs(const G& g, const std::vector<int>& a, const std::vector<int>& b) {
+  size_t k = 1;
+  while (k < a.size() && k < b.size() && a[k] == b[k]) ++k;
+  if (k == a.size() || k == b.size()) return a.size() > b.size();
+  for (const auto& vecino : Vecinos(g, a[k - 1])) {
+    if (vecino.first == b[k]) return true;
+    if (vecino.first == a[k]) return false;
+  }
+  return false;
+}
+
+// Contexto compartido por los hilos de DfsParalelo. Los hilos sin trabajo duermen en
+// hay_trabajo hasta que alguien deja una tarea en su deque o no queda ninguna pendiente.
+struct ContextoDfsParalelo {
+  std::vector<TrabajadorDfs> trabajadores;
+  std::atomic<size_t> pendientes{0};   // tareas creadas y aún sin terminar
+  std::atomic<size_t> disponibles{0};  // tareas en alguna deque que nadie ha cogido
+  std::atomic<int> ociosos{0};         // hilos que no encuentran trabajo
+  std::mutex m;
+  std::condition_variable hay_trabajo;
+
+  explicit ContextoDfsParalelo(int hilos) : trabajadores(static_cast<size_t>(hilos)) {}
+
+  // Despierta a los hilos dormidos tras cambiar 'disponibles' o 'pendientes' (tomar el
+  // mutex antes de avisar evita que el aviso se pierda entre su comprobación y su espera)
+  void Avisar(bool todos) {
+    { std::lock_guard<std::mutex> lock(m); }
+    if (todos) hay_trabajo.notify_all();
+    else hay_trabajo.notify_one();
+  }
+};
+
+// Cada cuántas expansiones mira un hilo ocupado si tiene que ceder trabajo
+constexpr int kPasosEntreCesiones = 64;
+
+// Explora en profundidad el subárbol de una tarea, igual que DfsImpl en búsqueda en
+// árbol sin parada. 'camino' hace de pila desde el inicio de la tarea y 'pos' guarda
+// por qué vecino va cada vértice de la pila. Cada kPasosEntreCesiones expansiones, si hay
+// hilos ociosos y la deque propia está vacía, se les cede el resto de hermanos del nivel
+// más alto que aún tenga (el mutex solo se toma cuando de verdad se va a ceder).
+template <typename G>
+void ExplorarTareaDfs(const G& g, int destino, TareaDfs tarea, TrabajadorDfs& yo, MarcasVertice& en_camino,
+                      ContextoDfsParalelo& ctx) {
+  std::vector<int>& camino = tarea.camino;
+  const size_t base = camino.size() - 1;
+  en_camino.Reiniciar(g.GetNumVertices());
+  for (const int v : camino) en_camino.Marcar(v);
+
+  auto anotar_solucion = [&]() {
+    if (yo.ultima_solucion.empty() || SaleDespuesEnDfs(g, camino, yo.ultima_solucion)) yo.ultima_solucion = camino;
+  };
+  if (tarea.inspeccionar) {
+    yo.inspeccionados++;
+    if (camino.back() == destino) anotar_solucion();
+  }
+
+  std::vector<int> pos{tarea.pos};
+  int pasos = 0;
+  while (!pos.empty()) {
+    if (++pasos == kPasosEntreCesiones) {
+      pasos = 0;
+      if (ctx.ociosos.load(std::memory_order_relaxed) > 0 && yo.num_tareas.load(std::memory_order_relaxed) == 0) {
+        bool cedida = false;
+        {
+          std::lock_guard<std::mutex> lock(yo.m);
+          for (size_t i = 0; i + 1 < pos.size() && yo.tareas.empty(); ++i) {
+            const int grado = static_cast<int>(Vecinos(g, camino[base + i]).size());
+            if (pos[i] >= grado) continue;
+            ctx.pendientes.fetch_add(1);
+            yo.tareas.push_back({std::vector<int>(camino.begin(), camino.begin() + static_cast<long>(base + i) + 1),
+                                 pos[i], false});
+            yo.num_tareas.store(yo.tareas.size(), std::memory_order_relaxed);
+            pos[i] = grado;
+            cedida = true;
+          }
+        }
+        if (cedida) {
+          ctx.disponibles.fetch_add(1);
+          ctx.Avisar(false);
+        }
+      }
+    }
+
+    const size_t tope = pos.size() - 1;
+    const int u = camino[base + tope];
+    const auto& vecinos = Vecinos(g, u);
+    int p = pos[tope];
+    int hijo = 0;
+    while (p < static_cast<int>(vecinos.size())) {
+      const int v = vecinos[p++].first;
+      if (!en_camino.Marcado(v)) {
+        hijo = v;
+        break;
+      }
+    }
+    pos[tope] = p;
+
+    if (hijo == 0) {
+      // Sin más hijos: se retrocede
+      en_camino.Desmarcar(u);
+      camino.pop_back();
+      pos.pop_back();
+      continue;
+    }
+    // Se genera el hijo y se inspecciona al bajar a él
+    camino.push_back(hijo);
+    pos.push_back(0);
+    en_camino.Marcar(hijo);
+    yo.generados++;
+    yo.inspeccionados++;
+    if (hijo == destino) anotar_solucion();
+  }
+}
+
+// Bucle de cada hilo de DfsParalelo: saca tareas de su deque o se las roba a otro hasta
+// que no queda ninguna pendiente. Si no encuentra ninguna, duerme hasta que haya alguna
+// disponible en lugar de recorrer en bucle los mutex de los demás.
+template <typename G>
+void TrabajarDfs(const G& g, int destino, size_t id, ContextoDfsParalelo& ctx) {
+  TrabajadorDfs& yo = ctx.trabajadores[id];
+  const size_t num = ctx.trabajadores.size();
+  MarcasVertice en_camino;
+  bool ocioso = false;
+  while (true) {
+    TareaDfs tarea;
+    bool hay_tarea = false;
+    for (size_t k = 0; k < num && !hay_tarea; ++k) {
+      TrabajadorDfs& otro = ctx.trabajadores[(id + k) % num];
+      if (otro.num_tareas.load(std::memory_order_relaxed) == 0) continue;
+      std::lock_guard<std::mutex> lock(otro.m);
+      if (otro.tareas.empty()) continue;
+      if (k == 0) {
+        tarea = std::move(otro.tareas.back());
+        otro.tareas.pop_back();
+      } else {
+        tarea = std::move(otro.tareas.front());
+        otro.tareas.pop_front();
+      }
+      otro.num_tareas.store(otro.tareas.size(), std::memory_order_relaxed);
+      hay_tarea = true;
+    }
+    if (!hay_tarea) {
+      if (ctx.pendientes.load() == 0) break;
+      if (!ocioso) ctx.ociosos.fetch_add(1, std::memory_order_relaxed);
+      ocioso = true;
+      std::unique_lock<std::mutex> lock(ctx.m);
+      ctx.hay_trabajo.wait(lock, [&] { return ctx.disponibles.load() > 0 || ctx.pendientes.load() == 0; });
+      continue;
+    }
+    ctx.disponibles.fetch_sub(1);
+    if (ocioso) ctx.ociosos.fetch_sub(1, std::memory_order_relaxed);
+    ocioso = false;
+    ExplorarTareaDfs(g, destino, std::move(tarea), yo, en_camino, ctx);
+    // La última tarea despierta a todos para que terminen
+    if (ctx.pendientes.fetch_sub(1) == 1) ctx.Avisar(true);
+  }
+  if (ocioso) ctx.ociosos.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename G>
+trace::ResultadoBusqueda DfsParaleloImpl(const G& g, int origen, int destino, const trace::OpcionesBusqueda& opts,
+                                         int hilos, MarcasVertice& generados, MarcasVertice& en_camino,
+                                         ArenaArbol& arbol) {
+  // Con parada, en búsqueda en grafo o con poda por k_mejores el resultado depende del
+  // orden exacto del recorrido, así que se hace la búsqueda secuencial
+  if (opts.parar_a_primera_solucion || opts.busqueda_en_grafo || opts.k_mejores > 0) {
+    std::vector<int> buffer;
+    return DfsImpl(g, origen, destino, opts, generados, en_camino, arbol, ReceptorSoluciones(), buffer);
+  }
+  const int n = g.GetNumVertices();
+  if (origen < 1 || origen > n || destino < 1 || destino > n) {
+    throw std::out_of_range("origen/destino fuera de rango");
+  }
+  hilos = HilosEfectivos(hilos);
+
+  ContextoDfsParalelo ctx(hilos);
+  ctx.pendientes.store(1);
+  ctx.disponibles.store(1);
+  ctx.trabajadores[0].tareas.push_back({{origen}, 0, true});
+  ctx.trabajadores[0].num_tareas.store(1);
+
+  std::vector<std::thread> hilos_trabajo;
+  hilos_trabajo.reserve(static_cast<size_t>(hilos) - 1);
+  for (size_t t = 1; t < static_cast<size_t>(hilos); ++t) {
+    hilos_trabajo.emplace_back([&g, destino, t, &ctx]() { TrabajarDfs(g, destino, t, ctx); });
+  }
+  TrabajarDfs(g, destino, 0, ctx);
+  for (auto& hilo : hilos_trabajo) hilo.join();
+
+  trace::ResultadoBusqueda resultado;
+  trace::RegistroIteracion registro0;
+  registro0.paso = 1;
+  registro0.generados_delta.push_back(origen);
+  resultado.traza.push_back(std::move(registro0));
+  resultado.nodos_generados = 1;
+
+  // Los contadores se suman; la solución es la que la secuencial habría encontrado la última
+  for (const auto& trabajador : ctx.trabajadores) {
+    resultado.nodos_generados += trabajador.generados;
+    resultado.nodos_inspeccionados += trabajador.inspeccionados;
+    if (trabajador.ultima_solucion.empty()) continue;
+    if (resultado.camino.empty() || SaleDespuesEnDfs(g, trabajador.ultima_solucion, resultado.camino)) {
+      resultado.camino = trabajador.ultima_solucion;
+    }
+  }
+  if (!resultado.camino.empty()) {
+    resultado.found = true;
+    for (size_t i = 0; i + 1 < resultado.camino.size(); ++i) {
+      resultado.coste_total += g.GetPesoArista(resultado.camino[i], resultado.camino[i + 1]);
+    }
+  }
+  return resultado;
+}
+
+// Caminos más cortos de todos los vértices hacia 'destino' (Dijkstra desde el destino;
+// el grafo es no dirigido). distancia[v] es el coste mínimo de v al destino (infinito si
+// no llega) y siguiente[v] el vecino por el que sigue ese camino (0 en el destino).
+template <typename G>
+void DijkstraHaciaDestino(const G& g, int destino, std::vector<double>& distancia, std::vector<int>& siguiente,
+                          trace::ResultadoBusqueda& resultado) {
+  const size_t tamano = static_cast<size_t>(g.GetNumVertices()) + 1;
+  distancia.assign(tamano, std::numeric_limits<double>::infinity());
+  siguiente.assign(tamano, 0);
+  MonticuloRadix<int> frontera;
+  distancia[destino] = 0.0;
+  frontera.Insertar(0.0, destino);
+  resultado.nodos_generados++;
+  while (!frontera.Vacio()) {
+    const auto [d, v] = frontera.SacarMinimo();
+    if (d > distancia[v]) continue;  // entrada vieja
+    resultado.nodos_inspeccionados++;
+    for (const auto& vecino : Vecinos(g, v)) {
+      const double nueva = d + vecino.second;
+      if (nueva < distancia[vecino.first]) {
+        distancia[vecino.first] = nueva;
+        siguiente[vecino.first] = v;
+        frontera.Insertar(nueva, vecino.first);
+        resultado.nodos_generados++;
+      }
+    }
+  }
+}
+
+// Coste de un camino sumando sus aristas en orden (igual que ReconstruirSolucion)
+template <typename G>
+double CosteCamino(const G& g, const std::vector<int>& camino) {
+  double coste = 0.0;
+  for (size_t i = 0; i + 1 < camino.size(); ++i) coste += g.GetPesoArista(camino[i], camino[i + 1]);
+  return coste;
+}
+
+// Búsquedas de desvío de Yen. Todas comparten las distancias al destino del grafo
+// completo: si el camino más corto de un vértice de desvío no toca nada de lo quitado,
+// se usa tal cual; si no, se busca con A* usando esas distancias como heurística, que
+// sigue siendo consistente porque quitar vértices y aristas no acorta ningún camino.
+template <typename G>
+class DesviosYen {
+ public:
+  DesviosYen(const G& g, int destino, trace::ResultadoBusqueda& resultado)
+      : g_(g), destino_(destino), resultado_(resultado) {
+    DijkstraHaciaDestino(g, destino, distancia_, siguiente_, resultado);
+    coste_.resize(distancia_.size());
+    padre_.resize(distancia_.size());
+  }
+
+  bool Alcanza(int v) const { return distancia_[v] != std::numeric_limits<double>::infinity(); }
+
+  // Camino más corto de 'desde' al destino en el grafo completo
+  void CaminoMasCorto(int desde, std::vector<int>& tramo) const {
+    tramo.clear();
+    for (int x = desde; x != 0; x = siguiente_[x]) tramo.push_back(x);
+  }
+
+  // Camino más corto de 'desde' al destino sin pasar por los vértices 'bloqueados' ni
+  // por las aristas desde -> x con x en 'prohibidos'. Devuelve false si no hay.
+  bool Tramo(int desde, const MarcasVertice& bloqueados, const std::vector<int>& prohibidos,
+             std::vector<int>& tramo) {
+    if (!Alcanza(desde)) return false;
+    auto prohibido = [&](int x) { return std::find(prohibidos.begin(), prohibidos.end(), x) != prohibidos.end(); };
+
+    // Atajo: el camino más corto del grafo completo, si sigue siendo válido
+    bool valido = desde == destino_ || !prohibido(siguiente_[desde]);
+    for (int x = siguiente_[desde]; valido && x != 0; x = siguiente_[x]) valido = !bloqueados.Marcado(x);
+    if (valido) {
+      CaminoMasCorto(desde, tramo);
+      return true;
+    }
+
+    // A* con f = coste + distancia al destino
+    using Entrada = std::pair<double, int>;
+    std::priority_queue<Entrada, std::vector<Entrada>, std::greater<Entrada>> frontera;
+    vistos_.Reiniciar(g_.GetNumVertices());
+    cerrados_.Reiniciar(g_.GetNumVertices());
+    vistos_.Marcar(desde);
+    coste_[desde] = 0.0;
+    padre_[desde] = 0;
+    frontera.push({distancia_[desde], desde});
+    resultado_.nodos_generados++;
+    while (!frontera.empty()) {
+      const int v = frontera.top().second;
+      frontera.pop();
+      if (cerrados_.Marcado(v)) continue;  // entrada vieja
+      cerrados_.Marcar(v);
+      resultado_.nodos_inspeccionados++;
+      if (v == destino_) {
+        tramo.clear();
+        for (int x = v; x != 0; x = padre_[x]) tramo.push_back(x);
+        std::reverse(tramo.begin(), tramo.end());
+        return true;
+      }
+      for (const auto& vecino : Vecinos(g_, v)) {
+        const int u = vecino.first;
+        if (bloqueados.Marcado(u) || cerrados_.Marcado(u) || !Alcanza(u)) continue;
+        if (v == desde && prohibido(u)) continue;
+        const double nuevo = coste_[v] + vecino.second;
+        if (vistos_.Marcado(u) && nuevo >= coste_[u]) continue;
+        vistos_.Marcar(u);
+        coste_[u] = nuevo;
+        padre_[u] = v;
+        frontera.push({nuevo + distancia_[u], u});
+        resultado_.nodos_generados++;
+      }
+    }
+    return false;
+  }
+
+ private:
+  const G& g_;
+  int destino_;
+  trace::ResultadoBusqueda& resultado_;
+  std::vector<double> distancia_;  // distancia al destino en el grafo completo
+  std::vector<int> siguiente_;     // siguiente vértice del camino más corto al destino
+  std::vector<double> coste_;      // A*: coste desde el vértice de desvío (válido si está en vistos_)
+  std::vector<int> padre_;         // A*: vértice anterior (0 en el de desvío)
+  MarcasVertice vistos_;
+  MarcasVertice cerrados_;
+};
+
+template <typename G>
+trace::ResultadoBusqueda KCaminosMasCortosImpl(const G& g, int origen, int destino, size_t k) {
+  const int n = g.GetNumVertices();
+  if (origen < 1 || origen > n || destino < 1 || destino > n) {
+    throw std::out_of_range("origen/destino fuera de rango");
+  }
+  if (k == 0) throw std::invalid_argument("Hay que pedir al menos un camino (k >= 1)");
+
+  trace::ResultadoBusqueda resultado;
+  trace::RegistroIteracion registro0;
+  registro0.paso = 1;
+  registro0.generados_delta.push_back(origen);
+  resultado.traza.push_back(std::move(registro0));
+
+  DesviosYen<G> desvios(g, destino, resultado);
+  if (!desvios.Alcanza(origen)) return resultado;
+
+  // Caminos aceptados, con el índice en que se desvían del camino del que salieron:
+  // los desvíos anteriores a ese índice ya se probaron desde el padre (mejora de Lawler)
+  struct CaminoYen {
+    std::vector<int> camino;
+    double coste;
+    size_t desvio;
+  };
+  std::vector<CaminoYen> aceptados;
+  {
+    CaminoYen primero{{}, 0.0, 0};
+    desvios.CaminoMasCorto(origen, primero.camino);
+    primero.coste = CosteCamino(g, primero.camino);
+    aceptados.push_back(std::move(primero));
+  }
+
+  // Candidatos ordenados por (coste, camino); el mapa también quita los repetidos
+  std::map<std::pair<double, std::vector<int>>, size_t> candidatos;
+  MarcasVertice bloqueados;
+  std::vector<int> prohibidos;
+  std::vector<int> tramo;
+
+  while (aceptados.size() < k) {
+    const CaminoYen previo = aceptados.back();
+    for (size_t i = previo.desvio; i + 1 < previo.camino.size(); ++i) {
+      // La raíz (previo[0..i]) se mantiene: sus vértices no se pueden volver a usar...
+      bloqueados.Reiniciar(n);
+      for (size_t j = 0; j < i; ++j) bloqueados.Marcar(previo.camino[j]);
+      // ...y desde el vértice de desvío no se puede seguir como ningún camino aceptado con la misma raíz
+      prohibidos.clear();
+      for (const auto& aceptado : aceptados) {
+        if (aceptado.camino.size() > i + 1 &&
+            std::equal(previo.camino.begin(), previo.camino.begin() + static_cast<long>(i) + 1,
+                       aceptado.camino.begin())) {
+          prohibidos.push_back(aceptado.camino[i + 1]);
+        }
+      }
+      if (!desvios.Tramo(previo.camino[i], bloqueados, prohibidos, tramo)) continue;
+
+      std::vector<int> nuevo(previo.camino.begin(), previo.camino.begin() + static_cast<long>(i));
+      nuevo.insert(nuevo.end(), tramo.begin(), tramo.end());
+      const double coste = CosteCamino(g, nuevo);
+      candidatos.emplace(std::make_pair(coste, std::move(nuevo)), i);
+    }
+    if (candidatos.empty()) break;  // no hay más caminos simples
+
+    auto mejor = candidatos.begin();
+    aceptados.push_back({mejor->first.second, mejor->first.first, mejor->second});
+    candidatos.erase(mejor);
+  }
+
+  resultado.found = true;
+  for (auto& aceptado : aceptados) resultado.mejores.push_back({std::move(aceptado.camino), aceptado.coste});
+  resultado.camino = resultado.mejores.front().camino;
+  resultado.coste_total = resultado.mejores.front().coste;
+  return resultado;
+}
+}  // namespace
+
+trace::ResultadoBusqueda busqueda::Bfs(const Grafo& g, int origen, int destino,
+                                       const trace::OpcionesBusqueda& opts, const ReceptorSoluciones& receptor) {
+  return BfsImpl(g, origen, destino, opts, generados_, arbol_, receptor, camino_solucion_);
+}
+
+trace::ResultadoBusqueda busqueda::Bfs(const GrafoCsr& g, int origen, int destino,
+                                       const trace::OpcionesBusqueda& opts, const ReceptorSoluciones& receptor) {
+  return BfsImpl(g, origen, destino, opts, generados_, arbol_, receptor, camino_solucion_);
+}
+
+trace::ResultadoBusqueda busqueda::Dfs(const Grafo& g, int origen, int destino,
+                                       const trace::OpcionesBusqueda& opts, const ReceptorSoluciones& receptor) {
+  return DfsImpl(g, origen, destino, opts, generados_, en_camino_, arbol_, receptor, camino_solucion_);
+}
+
+trace::ResultadoBusqueda busqueda::Dfs(const GrafoCsr& g, int origen, int destino,
+                                       const trace::OpcionesBusqueda& opts, const ReceptorSoluciones& receptor) {
+  return DfsImpl(g, origen, destino, opts, generados_, en_camino_, arbol_, receptor, camino_solucion_);
+}
+
+trace::ResultadoBusqueda busqueda::BfsModi(const Grafo& g, int origen, int destino,
+                                           const trace::OpcionesBusqueda& opts, const ReceptorSoluciones& receptor) {
+  return BfsModiImpl(g, origen, destino, opts, generados_, arbol_, receptor, camino_solucion_);
+}
+
+trace::ResultadoBusqueda busqueda::BfsModi(const GrafoCsr& g, int origen, int destino,
+                                           const trace::OpcionesBusqueda& opts, const ReceptorSoluciones& receptor) {
+  return BfsModiImpl(g, origen, destino, opts, generados_, arbol_, receptor, camino_solucion_);
+}
+
+trace::ResultadoBusqueda busqueda::Ucs(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts) {
+  return UcsImpl(g, origen, destino, opts, generados_, cerrados_, mejor_coste_, frontera_ucs_, arbol_);
+}
+
+trace::ResultadoBusqueda busqueda::Ucs(const GrafoCsr& g, int origen, int destino, const trace::OpcionesBusqueda& opts) {
+  return UcsImpl(g, origen, destino, opts, generados_, cerrados_, mejor_coste_, frontera_ucs_, arbol_);
+}
+
+trace::ResultadoBusqueda busqueda::BfsBidireccional(const Grafo& g, int origen, int destino,
+                                                   const trace::OpcionesBusqueda& /*opts*/) {
+  return BfsBidireccionalImpl(g, origen, destino, lado_origen_, lado_destino_);
+}
+
+trace::ResultadoBusqueda busqueda::BfsBidireccional(const GrafoCsr& g, int origen, int destino,
+                                                   const trace::OpcionesBusqueda& /*opts*/) {
+  return BfsBidireccionalImpl(g, origen, destino, lado_origen_, lado_destino_);
+}
+
+trace::ResultadoBusqueda busqueda::Iddfs(const Grafo& g, int origen, int destino, const trace::OpcionesBusqueda& opts) {
+  return IddfsImpl(g, origen, destino, opts, en_camino_);
+}
+
+trace::ResultadoBusqueda busqueda::Iddfs(const GrafoCsr& g, int origen, int destino, const trace::OpcionesBusqueda& opts) {
+  return IddfsImpl(g, origen, destino, opts, en_camino_);
+}
+
+trace::ArbolCaminos busqueda::BfsTodos(const Grafo& g, int origen) {
+  return BfsTodosImpl(g, origen);
+}
+
+trace::ArbolCaminos busqueda::BfsTodos(const GrafoCsr& g, int origen) {
+  return BfsTodosImpl(g, origen);
+}
+
+trace::ResultadoBusqueda busqueda::BfsParalelo(const Grafo& g, int origen, int destino,
+                                              const trace::OpcionesBusqueda& opts, int hilos) {
+  return BfsParaleloImpl(g, origen, destino, opts, hilos, bfs_paralelo_);
+}
+
+trace::ResultadoBusqueda busqueda::BfsParalelo(const GrafoCsr& g, int origen, int destino,
+                                              const trace::OpcionesBusqueda& opts, int hilos) {
+  return BfsParaleloImpl(g, origen, destino, opts, hilos, bfs_paralelo_);
+}
+
+trace::ResultadoBusqueda busqueda::DfsParalelo(const Grafo& g, int origen, int destino,
+                                              const trace::OpcionesBusqueda& opts, int hilos) {
+  return DfsParaleloImpl(g, origen, destino, opts, hilos, generados_, en_camino_, arbol_);
+}
+
+trace::ResultadoBusqueda busqueda::DfsParalelo(const GrafoCsr& g, int origen, int destino,
+                                              const trace::OpcionesBusqueda& opts, int hilos) {
+  return DfsParaleloImpl(g, origen, destino, opts, hilos, generados_, en_camino_, arbol_);
+}
+
+trace::ResultadoBusqueda busqueda::KCaminosMasCortos(const Grafo& g, int origen, int destino, size_t k) {
+  return KCaminosMasCortosImpl(g, origen, destino, k);
+}
+
+trace::ResultadoBusqueda busqueda::KCaminosMasCortos(const GrafoCsr& g, int origen, int destino, size_t k) {
+  return KCaminosMasCortosImpl(g, origen, destino, k);
+}
@@ -0,0 +1,59 @@
+#include "fichero_mapeado.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+FicheroMapeado::FicheroMapeado(const std::string& ruta) {
+  const int fd = ::open(ruta.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("No se pudo abrir el fichero: " + ruta);
+
+  struct stat info;
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::runtime_error("No se pudo consultar el tamaño del fichero: " + ruta);
+  }
+  tamano_ = static_cast<std::size_t>(info.st_size);
+  modificacion_ns_ = static_cast<std::uint64_t>(info.st_mtim.tv_sec) * 1000000000ULL +
+                     static_cast<std::uint64_t>(info.st_mtim.tv_nsec);
+
+  // mmap no admite longitud 0: un fichero vacío se queda con datos_ = nullptr
+  if (tamano_ > 0) {
+    void* p = ::mmap(nullptr, tamano_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("No se pudo proyectar en memoria el fichero: " + ruta);
+    }
+    // Lo vamos a leer de principio a fin: pedimos lectura anticipada al sistema
+    ::madvise(p, tamano_, MADV_SEQUENTIAL);
+    datos_ = static_cast<const char*>(p);
+  }
+  // Una vez proyectado, el descriptor ya no hace falta
+  ::close(fd);
+}
+
+FicheroMapeado::~FicheroMapeado() { Liberar(); }
+
+FicheroMapeado::FicheroMapeado(FicheroMapeado&& otro) noexcept
+    : datos_(std::exchange(otro.datos_, nullptr)), tamano_(std::exchange(otro.tamano_, 0)),
+      modificacion_ns_(std::exchange(otro.modificacion_ns_, 0)) {}
+
+FicheroMapeado& FicheroMapeado::operator=(FicheroMapeado&& otro) noexcept {
+  if (this != &otro) {
+    Liberar();
+    datos_ = std::exchange(otro.datos_, nullptr);
+    tamano_ = std::exchange(otro.tamano_, 0);
+    modificacion_ns_ = std::exchange(otro.modificacion_ns_, 0);
+  }
+  return *this;
+}
+
+void FicheroMapeado::Liberar() {
+  if (datos_ != nullptr) ::munmap(const_cast<char*>(datos_), tamano_);
+  datos_ = nullptr;
+  tamano_ = 0;
+}
@@ -5,13 +5,8 @@ Grafo::Grafo(int num_vertices) {
   num_vertices_ = num_vertices;
   nodos_.reserve(num_vertices);
   for (int i = 1; i <= num_vertices; ++i) nodos_.emplace_back(i);
-  //Inicializamos la matriz adyacente de ponderación con numero de vertices
-  // Además, inicializamos las aristas en -1.0, porque aun no existe arista entre los nodos
-  // El guión dice: d(i,j) = -1 si no hay una arista que conecte al vertice i con el vertice j.
-  pesos_.assign(num_vertices, std::vector<double>(num_vertices, -1.0));
-  for (int i = 0; i < num_vertices_; ++i) {
-    pesos_[i][i] = 0.0;   // d(i,i) = 0
-  }
+  // No guardamos matriz de pesos NxN: el peso de cada arista vive en la lista de vecinos
+  // de sus extremos, así que la memoria es O(N + M) aunque N sea muy grande.
 }
 
 void Grafo::VerificarVerticeOExcepcion(int u) const {
@@ -30,12 +25,8 @@ void Grafo::AnadirAristaNoDirigida(int u, int v, double peso) {
   // Y descomentar un trozo de codigo en AnadirVecino que se encarga de actualizar los nuevos pesos
   // if (ExisteArista(u,v)) return;
   
-  // Añadimos los pesos de las aristas a sus respectivos nodos, recordando que es un grafo no dirgido
+  // Añadimos los nuevos vecinos (con su peso), recordando que es un grafo no dirgido
   // con lo que si se le añado de A a B, también se tiene que hacer de B a A.
-  pesos_[u-1][v-1] = peso;
-  pesos_[v-1][u-1] = peso;
-
-  // Añadimos los nuevos vecinos
   nodos_[u-1].AnadirVecino(v, peso);
   nodos_[v-1].AnadirVecino(u, peso);
 }
@@ -44,17 +35,20 @@ bool Grafo::ExisteArista(int u, int v) const {
   // Comprobamos que los valores sean validos.
   VerificarVerticeOExcepcion(u);
   VerificarVerticeOExcepcion(v);
-  // Verificamos si ya existe una arista entre el nodo u y v,
-  // porque si existiera, quiere decir que ya estan agregados como vecinos,
-  // con lo que si en pesos_[u-1][v-1] != -1.0 quiere decir que ya hay un peso en la arista
-  // entonces según d(i,j) = -1 cuando no hay arista que conecte los vertices, en caso contrario si la hay
-  if (pesos_[u-1][v-1] != -1.0) return true;
-  return false;
+  // Según el guión d(i,j) = -1 cuando no hay arista que conecte los vertices,
+  // y d(i,i) = 0, así que un vértice siempre "tiene arista" consigo mismo
+  return GetPesoArista(u, v) != -1.0;
 }
 
 double Grafo::GetPesoArista(int u, int v) const {
-  if (ExisteArista(u,v)) return pesos_[u-1][v-1];   // Acedemos a la matriz adyacente de ponderación, la cual contiene los pesos de las aristas.
-  return -1.0;
+  VerificarVerticeOExcepcion(u);
+  VerificarVerticeOExcepcion(v);
+  if (u == v) return 0.0;   // d(i,i) = 0
+  // Buscamos en la lista de vecinos más corta: la arista está en las dos (grafo no dirigido)
+  const Nodo& nodo_u = nodos_[u-1];
+  const Nodo& nodo_v = nodos_[v-1];
+  if (nodo_u.GetVecinos().size() <= nodo_v.GetVecinos().size()) return nodo_u.GetPesoVecino(v);
+  return nodo_v.GetPesoVecino(u);
 }
 
 const std::vector<std::pair<int, double>>& Grafo::GetVecinosPorId(int id) const {
@@ -63,12 +57,8 @@ const std::vector<std::pair<int, double>>& Grafo::GetVecinosPorId(int id) const
 }
 
 void Grafo::LimpiarAristas() {
-  // Eliminamos todas las pesos de las aristas y las inicialimos a -1.0 d(i,j) = -1 si no hay una arista que conecte al vértice i con el vértice j. 
-  // Con assign reemplazamos el contenido, mantenemos la estructura correcta
-  pesos_.assign(num_vertices_, std::vector<double>(num_vertices_, -1.0));
-  // Recordemos que d(i,i) = 0
-  for (int i = 0; i < num_vertices_; ++i) pesos_[i][i] = 0.0;
-  // Ahora eliminamos los vecinos de todos los nodos
+  // Los pesos viven en las listas de vecinos, así que basta con vaciarlas:
+  // después, d(i,j) = -1 para todo i != j
   for (auto& nodo : nodos_) {
     nodo.LimpiarVecinos();
   }
@@ -0,0 +1,81 @@
+#include "grafo_builder.h"
+
+#include <algorithm>
+#include <utility>
+
+GrafoBuilder::GrafoBuilder(int num_vertices) {
+  if (num_vertices < 1) throw std::invalid_argument("El número de vertices no puede ser < 1");
+  num_vertices_ = num_vertices;
+}
+
+void GrafoBuilder::VerificarVerticeOExcepcion(int u) const {
+  if (u < 1) throw std::out_of_range("El vértice no debe ser < 1.");
+  if (u > num_vertices_) throw std::out_of_range("El vértice no puede ser > num_vertices_.");
+}
+
+void GrafoBuilder::AnadirAristaNoDirigida(int u, int v, double peso) {
+  // Mismas comprobaciones que Grafo::AnadirAristaNoDirigida, para fallar en el mismo sitio
+  VerificarVerticeOExcepcion(u);
+  VerificarVerticeOExcepcion(v);
+  if (u == v) throw std::invalid_argument("Self-loop no permitido.");
+  if (peso < 0.0) throw std::invalid_argument("El peso no debe ser < 0.0");
+  aristas_.push_back({u, v, peso});
+}
+
+Grafo GrafoBuilder::Construir() {
+  const std::size_t n = static_cast<std::size_t>(num_vertices_);
+
+  // Contamos cuántas entradas tendrá cada lista de vecinos (cada arista cuenta en sus dos extremos)
+  std::vector<std::size_t> inicio(n + 1, 0);
+  for (const Arista& a : aristas_) {
+    ++inicio[a.u];
+    ++inicio[a.v];
+  }
+  for (std::size_t i = 1; i <= n; ++i) inicio[i] += inicio[i - 1];
+
+  // Repartimos las aristas por vértice (counting sort). Recorremos en orden de llegada,
+  // así que dentro de cada vértice las entradas quedan en orden de inserción
+  std::vector<std::pair<int, double>> entradas(inicio[n]);
+  std::vector<std::size_t> pos(inicio.begin(), inicio.end() - 1);
+  for (const Arista& a : aristas_) {
+    entradas[pos[a.u - 1]++] = {a.v, a.peso};
+    entradas[pos[a.v - 1]++] = {a.u, a.peso};
+  }
+  aristas_.clear();
+  aristas_.shrink_to_fit();
+
+  Grafo grafo(num_vertices_);
+  std::vector<std::pair<int, double>> vecinos;
+  for (std::size_t i = 0; i < n; ++i) {
+    auto ini = entradas.begin() + static_cast<std::ptrdiff_t>(inicio[i]);
+    auto fin = entradas.begin() + static_cast<std::ptrdiff_t>(inicio[i + 1]);
+    // Ordenación estable por id: los duplicados quedan en orden de inserción
+    std::stable_sort(ini, fin, [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+      return a.first < b.first;
+    });
+
+    // Quitamos duplicados quedándonos con el último peso (igual que AnadirVecino)
+    vecinos.clear();
+    for (auto it = ini; it != fin; ++it) {
+      if (!vecinos.empty() && vecinos.back().first == it->first) {
+        vecinos.back().second = it->second;
+      } else {
+        vecinos.push_back(*it);
+      }
+    }
+    grafo.nodos_[i].AsignarVecinos(vecinos);
+  }
+  return grafo;
+}
+
+Grafo GrafoBuilder::DesdeCsr(const GrafoCsr& csr) {
+  Grafo grafo(csr.GetNumVertices());
+  std::vector<std::pair<int, double>> vecinos;
+  for (int v = 1; v <= csr.GetNumVertices(); ++v) {
+    const VecinosCsr fila = csr.GetVecinosSinComprobar(v);
+    vecinos.clear();
+    for (const auto& vecino : fila) vecinos.push_back(vecino);
+    grafo.nodos_[v - 1].AsignarVecinos(vecinos);
+  }
+  return grafo;
+}
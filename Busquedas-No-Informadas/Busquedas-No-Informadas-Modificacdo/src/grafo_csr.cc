@@ -0,0 +1,66 @@
+#include "grafo_csr.h"
+
+#include <algorithm>
+#include <utility>
+
+GrafoCsr::GrafoCsr(const Grafo& grafo) : num_vertices_(grafo.GetNumVertices()) {
+  // Primera pasada: contamos los vecinos de cada nodo para saber dónde empieza cada fila
+  offsets_propios_.assign(static_cast<std::size_t>(num_vertices_) + 1, 0);
+  for (int v = 1; v <= num_vertices_; ++v) {
+    offsets_propios_[v] = offsets_propios_[v - 1] + grafo.GetVecinosPorId(v).size();
+  }
+
+  // Segunda pasada: copiamos los vecinos (ya ordenados en Nodo) a los arrays contiguos
+  ids_propios_.reserve(offsets_propios_.back());
+  pesos_propios_.reserve(offsets_propios_.back());
+  for (int v = 1; v <= num_vertices_; ++v) {
+    for (const auto& vecino : grafo.GetVecinosPorId(v)) {
+      ids_propios_.push_back(vecino.first);
+      pesos_propios_.push_back(vecino.second);
+    }
+  }
+
+  num_entradas_ = offsets_propios_.back();
+  offsets_ = offsets_propios_.data();
+  ids_ = ids_propios_.data();
+  pesos_ = pesos_propios_.data();
+}
+
+GrafoCsr::GrafoCsr(std::shared_ptr<const FicheroMapeado> mapeo, int num_vertices, std::uint64_t num_entradas,
+                   const std::uint64_t* offsets, const std::int32_t* ids, const double* pesos)
+    : num_vertices_(num_vertices), num_entradas_(num_entradas), offsets_(offsets), ids_(ids), pesos_(pesos),
+      mapeo_(std::move(mapeo)) {
+  if (num_vertices_ < 1) throw std::invalid_argument("El número de vertices no puede ser < 1");
+  // Solo comprobamos los extremos (O(1)): recorrer todos los offsets anularía el arranque instantáneo
+  if (offsets_[0] != 0 || offsets_[num_vertices_] != num_entradas_) {
+    throw std::invalid_argument("Los offsets CSR no cuadran con el número de entradas");
+  }
+}
+
+void GrafoCsr::VerificarVerticeOExcepcion(int u) const {
+  if (u < 1) throw std::out_of_range("El vértice no debe ser < 1.");
+  if (u > num_vertices_) throw std::out_of_range("El vértice no puede ser > num_vertices_.");
+}
+
+bool GrafoCsr::ExisteArista(int u, int v) const {
+  return GetPesoArista(u, v) != -1.0;
+}
+
+double GrafoCsr::GetPesoArista(int u, int v) const {
+  VerificarVerticeOExcepcion(u);
+  VerificarVerticeOExcepcion(v);
+  // d(i,i) = 0, igual que en Grafo
+  if (u == v) return 0.0;
+
+  // Las filas están ordenadas por id, así que buscamos v en la fila de u con búsqueda binaria
+  const VecinosCsr vecinos = GetVecinosSinComprobar(u);
+  const std::int32_t* fin = vecinos.Ids() + vecinos.size();
+  const std::int32_t* it = std::lower_bound(vecinos.Ids(), fin, v);
+  if (it == fin || *it != v) return -1.0;
+  return vecinos.Pesos()[it - vecinos.Ids()];
+}
+
+VecinosCsr GrafoCsr::GetVecinosPorId(int id) const {
+  VerificarVerticeOExcepcion(id);
+  return GetVecinosSinComprobar(id);
+}
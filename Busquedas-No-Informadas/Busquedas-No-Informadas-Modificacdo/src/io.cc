@@ -1,7 +1,16 @@
 #include "io.h"
 #include "busqueda.h"
+#include "grafo_builder.h"
+#include "fichero_mapeado.h"
+#include "checksum.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <exception>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <string>
 #include <stdexcept>
 #include <vector>
@@ -9,32 +18,427 @@
 #include <iomanip>
 #include <sstream>
 #include <set>
+#include <thread>
+
+#include <unistd.h>
 
 namespace {
+// Tamaño mínimo de trozo para que la lectura en paralelo compense (1 MiB por hilo)
+constexpr std::size_t kMinBytesPorHilo = 1 << 20;
+
+/**
+ * @brief Trocea un bloque de memoria en tokens separados por espacios, sin copiarlos.
+ *        Cada token es un trozo [ini, ini + longitud) del propio bloque.
+ */
+class LectorTokens {
+ public:
+  LectorTokens(const char* ini, const char* fin) : p_(ini), fin_(fin) {}
+
+  /**
+   * @brief Avanza hasta el siguiente token.
+   * @param ini Inicio del token leído.
+   * @param longitud Longitud del token leído.
+   * @return true si se leyó un token, false si se llegó al final del bloque.
+   */
+  bool Siguiente(const char*& ini, std::size_t& longitud) {
+    while (p_ != fin_ && EsEspacio(*p_)) ++p_;
+    if (p_ == fin_) return false;
+    ini = p_;
+    while (p_ != fin_ && !EsEspacio(*p_)) ++p_;
+    longitud = static_cast<std::size_t>(p_ - ini);
+    return true;
+  }
+
+ private:
+  const char* p_;     ///< Posición actual.
+  const char* fin_;   ///< Fin del bloque.
+
+  // Mismos separadores que operator>>: espacio, \t, \n, \v, \f y \r
+  static bool EsEspacio(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+};
+
+/**
+ * @brief Convierte un token a double, aceptando tanto '.' como ',' como separador decimal.
+ *        No reserva memoria: copia el token a un buffer en la pila (cambiando ',' por '.')
+ *        y lo convierte con std::from_chars.
+ * @param ini Inicio del token.
+ * @param longitud Longitud del token.
+ * @param valor Valor leído (solo se modifica si la conversión es correcta).
+ * @return true si todo el token es un número válido, false en caso contrario.
+ */
+bool ParseFlexibleDouble(const char* ini, std::size_t longitud, double& valor) {
+  char buffer[64];
+  // Un peso razonable nunca ocupa tanto; si lo hace, lo tratamos como inválido
+  if (longitud == 0 || longitud >= sizeof(buffer)) return false;
+  // from_chars no acepta el signo '+', que std::stod sí aceptaba
+  if (*ini == '+') { ++ini; --longitud; }
+  for (std::size_t k = 0; k < longitud; ++k) buffer[k] = (ini[k] == ',') ? '.' : ini[k];
+  const auto res = std::from_chars(buffer, buffer + longitud, valor);
+  return res.ec == std::errc() && res.ptr == buffer + longitud;
+}
+
 /**
- * @brief Lee el siguiente token (palabra) del flujo de entrada.
- * @param in Flujo de entrada.
- * @param token String donde se almacena el token leído.
- * @return true si se leyó un token, false si se llegó al final del flujo
+ * @brief Devuelve la posición (i,j) en el formato de los mensajes de error.
  */
-bool SiguienteToken(std::istream& in, std::string& token) {
-  token.clear();  
-  // Lee el siguiente token (palabra) del flujo
-  if(!(in >> token)) return false;    // Usamos el operador >> que ya trocea por espacios
-  return true;
+std::string Posicion(int i, int j) {
+  return "(" + std::to_string(i) + "," + std::to_string(j) + ")";
 }
 
 /**
- * @brief Convierte un string a double, aceptando tanto '.' como ',' como separador decimal.
- * @param s String a convertir.
- * @return Valor double representado por el string.
- * @throws std::invalid_argument Si el string no es un número válido.
- * @throws std::out_of_range Si el número está fuera del rango representable por un double.
+ * @brief Convierte el token del peso d(i,j) y comprueba que es válido.
+ * @return Peso leído (-1 si no hay arista).
+ * @throws std::runtime_error Si el token no es un número o es < -1.
  */
-double ParseFlexibleDouble(std::string s) {
-  for (char& c : s) if (c == ',') c = '.';
-  // std::stod sirve para convertir string a double
-  return std::stod(s);
+double LeerPeso(const char* token, std::size_t longitud, int i, int j) {
+  double peso = 0.0;
+  if (!ParseFlexibleDouble(token, longitud, peso)) {
+    throw std::runtime_error("Peso no numérico '" + std::string(token, longitud) + "' en " + Posicion(i, j));
+  }
+  if (peso < -1.0) throw std::runtime_error("Peso inválido (< -1) en " + Posicion(i, j));
+  return peso;
+}
+
+/**
+ * @brief Arista leída por un hilo del cargador paralelo, pendiente de pasar al GrafoBuilder.
+ */
+struct AristaLeida {
+  int u;
+  int v;
+  double peso;
+};
+
+/**
+ * @brief Trozo del fichero que procesa un hilo del cargador paralelo.
+ *        - [ini, fin): bytes del trozo (empieza y acaba en un separador, nunca corta un token).
+ *        - primer_token: índice global (0-based) del primer peso del trozo.
+ *        - num_tokens: número de pesos del trozo.
+ *        - aristas: aristas con peso >= 0 encontradas en el trozo (buffer propio del hilo).
+ *        - error: excepción lanzada al procesar el trozo, si la hubo.
+ */
+struct Trozo {
+  const char* ini = nullptr;
+  const char* fin = nullptr;
+  long long primer_token = 0;
+  long long num_tokens = 0;
+  std::vector<AristaLeida> aristas;
+  std::exception_ptr error;
+};
+
+/**
+ * @brief Pasa del índice global k (0-based) de un peso a su posición (i,j).
+ *        La fila i tiene N-i pesos (j = i+1..N), así que basta con ir restando filas.
+ */
+void PosicionDeToken(long long k, int n, int& i, int& j) {
+  i = 1;
+  while (i < n && k >= n - i) {
+    k -= n - i;
+    ++i;
+  }
+  j = i + 1 + static_cast<int>(k);
+}
+
+/**
+ * @brief Lee los pesos de la matriz triangular repartiendo el fichero entre varios hilos.
+ *
+ * 1. Partimos [ini, fin) en tantos trozos como hilos, cortando en fin de línea.
+ * 2. Cada hilo cuenta los tokens de su trozo; con la suma acumulada sabemos el
+ *    índice global del primer peso de cada trozo y, por tanto, su (i,j).
+ * 3. Cada hilo convierte su trozo y guarda las aristas en su propio buffer.
+ * 4. Volcamos los buffers al builder en orden de trozo (el mismo orden que en secuencial).
+ *
+ * Si varios trozos tienen errores, se relanza el del primero, que es el que
+ * habría encontrado la lectura secuencial.
+ *
+ * @return Número de pesos leídos (como mucho, los esperados).
+ */
+long long LeerPesosEnParalelo(const char* ini, const char* fin, int num_vertices, long long esperados,
+                              int hilos, GrafoBuilder& builder) {
+  const std::size_t tamano = static_cast<std::size_t>(fin - ini);
+  std::vector<Trozo> trozos(static_cast<std::size_t>(hilos));
+
+  // 1. Fronteras de los trozos: avanzamos cada corte hasta después del siguiente '\n'
+  const char* corte = ini;
+  for (int t = 0; t < hilos; ++t) {
+    trozos[t].ini = corte;
+    const char* objetivo = (t + 1 == hilos) ? fin : ini + tamano / hilos * (t + 1);
+    if (objetivo < corte) objetivo = corte;
+    while (objetivo != fin && *objetivo != '\n') ++objetivo;
+    if (objetivo != fin) ++objetivo;
+    trozos[t].fin = objetivo;
+    corte = objetivo;
+  }
+
+  // Lanza f(t) en un hilo por trozo y espera a que acaben todos
+  auto en_paralelo = [&](auto f) {
+    std::vector<std::thread> threads;
+    threads.reserve(trozos.size());
+    for (std::size_t t = 0; t < trozos.size(); ++t) threads.emplace_back(f, t);
+    for (auto& th : threads) th.join();
+  };
+
+  // 2. Contamos tokens por trozo
+  en_paralelo([&](std::size_t t) {
+    LectorTokens lector(trozos[t].ini, trozos[t].fin);
+    const char* token = nullptr;
+    std::size_t longitud = 0;
+    while (lector.Siguiente(token, longitud)) ++trozos[t].num_tokens;
+  });
+  long long total = 0;
+  for (Trozo& trozo : trozos) {
+    trozo.primer_token = total;
+    total += trozo.num_tokens;
+  }
+
+  // 3. Convertimos cada trozo a aristas (solo hasta el último peso esperado;
+  //    lo que sobre al final se ignora, igual que en la lectura secuencial)
+  en_paralelo([&](std::size_t t) {
+    Trozo& trozo = trozos[t];
+    if (trozo.primer_token >= esperados) return;
+    try {
+      int i = 0, j = 0;
+      PosicionDeToken(trozo.primer_token, num_vertices, i, j);
+      const long long ultimo = std::min(trozo.primer_token + trozo.num_tokens, esperados);
+      LectorTokens lector(trozo.ini, trozo.fin);
+      const char* token = nullptr;
+      std::size_t longitud = 0;
+      for (long long k = trozo.primer_token; k < ultimo; ++k) {
+        lector.Siguiente(token, longitud);
+        const double peso = LeerPeso(token, longitud, i, j);
+        if (peso >= 0.0) trozo.aristas.push_back({i, j, peso});
+        // Siguiente posición de la matriz triangular
+        if (++j > num_vertices) {
+          ++i;
+          j = i + 1;
+        }
+      }
+    } catch (...) {
+      trozo.error = std::current_exception();
+    }
+  });
+
+  // 4. Errores en orden de trozo y volcado al builder
+  for (const Trozo& trozo : trozos) {
+    if (trozo.error) std::rethrow_exception(trozo.error);
+  }
+  if (total < esperados) {
+    int i = 0, j = 0;
+    PosicionDeToken(total, num_vertices, i, j);
+    throw std::runtime_error("Error leyendo peso para " + Posicion(i, j));
+  }
+  std::size_t num_aristas = 0;
+  for (const Trozo& trozo : trozos) num_aristas += trozo.aristas.size();
+  builder.ReservarAristas(num_aristas);
+  for (Trozo& trozo : trozos) {
+    for (const AristaLeida& a : trozo.aristas) builder.AnadirAristaNoDirigida(a.u, a.v, a.peso);
+    // Liberamos el buffer del hilo en cuanto está volcado
+    std::vector<AristaLeida>().swap(trozo.aristas);
+  }
+  return std::min(total, esperados);
+}
+
+/**
+ * @brief Lee una instancia en el formato de la práctica (matriz triangular superior)
+ *        desde un bloque de memoria.
+ * @param ini Inicio del contenido.
+ * @param fin Fin del contenido.
+ * @param hilos Número de hilos para convertir los pesos (1 = secuencial).
+ * @return Problema con el grafo construido.
+ * @throws std::runtime_error Si hay errores de formato.
+ */
+io::DatosLectura LeerTriangular(const char* ini, const char* fin, int hilos) {
+  LectorTokens lector(ini, fin);
+  const char* token = nullptr;
+  std::size_t longitud = 0;
+
+  // Leemos el número de vértices
+  double valor = 0.0;
+  if (!lector.Siguiente(token, longitud) || !ParseFlexibleDouble(token, longitud, valor)) {
+    throw std::runtime_error("Error leyendo número de vértices");
+  }
+  // Convertimos a int el número de vértices
+  int num_vertices = static_cast<int>(valor);
+  if (num_vertices < 1) throw std::runtime_error("Número de vértices debe ser >= 1");
+
+  // Apuntamos las aristas en bloque y construimos el grafo al final (ver GrafoBuilder)
+  GrafoBuilder builder(num_vertices);
+
+  // Creamos una variable que determina cuantas aristas esperamos leer
+  // (en 64 bits: con N grande, N*(N-1)/2 no cabe en un int)
+  const long long n = num_vertices;
+  long long esperados = n * (n - 1) / 2; // Máximo número de aristas en grafo no dirigido sin bucles
+  long long leidos = 0;
+
+  // Los ficheros pequeños no compensan el coste de lanzar hilos
+  const char* pesos = token + longitud;
+  if (hilos > 1 && static_cast<std::size_t>(fin - pesos) >= kMinBytesPorHilo * static_cast<std::size_t>(hilos)) {
+    leidos = LeerPesosEnParalelo(pesos, fin, num_vertices, esperados, hilos, builder);
+  } else {
+    // Leemos las aristas
+    // Funciona asi:
+    // i = 1             | i = 2             | i = 3             | ... | i = N-1
+    // j = 2, 3, ..., N. | j = 3, 4, ..., N. | j = 4, 5, ..., N. | ... | j = N
+    // Entonces, para cada i, j comienza en i+1 y termina en N
+    for (int i = 1; i <= num_vertices - 1; ++i) {
+      for (int j = i + 1; j <= num_vertices; ++j) {
+        if (!lector.Siguiente(token, longitud)) {
+          throw std::runtime_error("Error leyendo peso para " + Posicion(i, j));
+        }
+        const double peso = LeerPeso(token, longitud, i, j);
+        if (peso >= 0.0) builder.AnadirAristaNoDirigida(i, j, peso);
+
+        leidos++;
+      }
+    }
+  }
+
+
+  // Si no hemos leido el número esperado de pesos, lanzamos error
+  if (leidos != esperados) {
+    throw std::runtime_error("Conteo de pesos incorrecto (leídos " + std::to_string(leidos) +
+                             ", esperados " + std::to_string(esperados) + ")");
+  }
+
+  // Construimos el Problema: el resto (origen, destino, etc.) los fijarás fuera
+  io::DatosLectura problema{builder.Construir(), 1, 1, io::Algoritmo::kBfs, {}};
+
+  return problema;
+}
+
+/**
+ * @brief Convierte un token a entero (sin signo '+' ni decimales).
+ * @return true si todo el token es un entero válido, false en caso contrario.
+ */
+bool ParseEntero(const char* ini, std::size_t longitud, long long& valor) {
+  if (longitud == 0) return false;
+  const auto res = std::from_chars(ini, ini + longitud, valor);
+  return res.ec == std::errc() && res.ptr == ini + longitud;
+}
+
+/**
+ * @brief Lee una instancia en formato lista de aristas desde un bloque de memoria:
+ *        - Cabecera "N M": número de vértices y número de aristas.
+ *        - M líneas "u v w": arista no dirigida entre u y v (1-based) con peso w (>= 0).
+ *          El peso acepta '.' o ',' como separador decimal, igual que la matriz triangular.
+ *
+ *        El tamaño del fichero y el coste de lectura son O(N + M), así que sirve para
+ *        grafos con millones de vértices que no caben en el formato triangular.
+ * @param ini Inicio del contenido.
+ * @param fin Fin del contenido.
+ * @return Problema con el grafo construido.
+ * @throws std::runtime_error Si hay errores de formato o aristas inválidas.
+ */
+io::DatosLectura LeerListaAristas(const char* ini, const char* fin) {
+  LectorTokens lector(ini, fin);
+  const char* token = nullptr;
+  std::size_t longitud = 0;
+
+  // Cabecera: N M
+  long long num_vertices = 0;
+  long long esperados = 0;
+  if (!lector.Siguiente(token, longitud) || !ParseEntero(token, longitud, num_vertices)) {
+    throw std::runtime_error("Error leyendo número de vértices");
+  }
+  if (num_vertices < 1 || num_vertices > std::numeric_limits<int>::max()) {
+    throw std::runtime_error("Número de vértices debe ser >= 1 y caber en un int");
+  }
+  if (!lector.Siguiente(token, longitud) || !ParseEntero(token, longitud, esperados) || esperados < 0) {
+    throw std::runtime_error("Error leyendo número de aristas");
+  }
+
+  GrafoBuilder builder(static_cast<int>(num_vertices));
+  builder.ReservarAristas(static_cast<std::size_t>(esperados));
+
+  long long leidos = 0;
+  for (long long k = 1; k <= esperados; ++k) {
+    // El texto del error solo se construye si hace falta (nada de memoria por arista)
+    auto donde = [k]() { return " en la arista " + std::to_string(k); };
+    long long u = 0, v = 0;
+    double peso = 0.0;
+    if (!lector.Siguiente(token, longitud) || !ParseEntero(token, longitud, u) ||
+        !lector.Siguiente(token, longitud) || !ParseEntero(token, longitud, v)) {
+      throw std::runtime_error("Error leyendo extremos" + donde());
+    }
+    if (!lector.Siguiente(token, longitud) || !ParseFlexibleDouble(token, longitud, peso)) {
+      throw std::runtime_error("Error leyendo peso" + donde() + " " + Posicion(static_cast<int>(u), static_cast<int>(v)));
+    }
+    if (u < 1 || u > num_vertices || v < 1 || v > num_vertices) {
+      throw std::runtime_error("Vértice fuera de rango" + donde());
+    }
+    // Las mismas comprobaciones que la matriz: el builder rechaza bucles y pesos negativos
+    try {
+      builder.AnadirAristaNoDirigida(static_cast<int>(u), static_cast<int>(v), peso);
+    } catch (const std::exception& e) {
+      throw std::runtime_error(std::string(e.what()) + donde() + " " + Posicion(static_cast<int>(u), static_cast<int>(v)));
+    }
+    leidos++;
+  }
+
+  if (leidos != esperados) {
+    throw std::runtime_error("Conteo de aristas incorrecto (leídas " + std::to_string(leidos) +
+                             ", esperadas " + std::to_string(esperados) + ")");
+  }
+
+  io::DatosLectura problema{builder.Construir(), 1, 1, io::Algoritmo::kBfs, {}};
+
+  return problema;
+}
+
+/**
+ * @brief Detecta el formato del contenido.
+ *
+ *        Si la primera línea solo tiene N, es una matriz triangular. Si tiene "N M" puede
+ *        ser una lista de aristas, pero la lectura original no miraba los saltos de línea
+ *        y aceptaba también una matriz triangular con varios pesos en la primera línea
+ *        (p. ej. "3 5\n-1\n7\n"), así que en ese caso se cuentan los tokens:
+ *        - exactamente 1 + N(N-1)/2: matriz triangular (aunque también cuadre como
+ *          lista de aristas; para esos casos está --formato aristas).
+ *        - exactamente 2 + 3M: lista de aristas.
+ *        - más de 1 + N(N-1)/2 (la lectura original ignoraba lo que sobra): matriz triangular.
+ *        - menos: lista de aristas.
+ *        Cada token ocupa al menos 2 bytes con su separador, así que si el fichero es
+ *        demasiado pequeño para la matriz se decide sin recorrerlo (el caso de los grafos
+ *        grandes en lista de aristas, donde N(N-1)/2 es enorme).
+ */
+io::FormatoEntrada DetectarFormato(const char* ini, const char* fin) {
+  const char* p = ini;
+  // Saltamos separadores iniciales y el primer token
+  while (p != fin && (*p == ' ' || (*p >= '\t' && *p <= '\r'))) ++p;
+  while (p != fin && !(*p == ' ' || (*p >= '\t' && *p <= '\r'))) ++p;
+  // ¿Queda otro token en la misma línea?
+  while (p != fin && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+  if (p == fin || *p == '\n') return io::FormatoEntrada::kTriangular;
+
+  LectorTokens lector(ini, fin);
+  const char* token = nullptr;
+  std::size_t longitud = 0;
+  double valor = 0.0;
+  lector.Siguiente(token, longitud);
+  if (!ParseFlexibleDouble(token, longitud, valor) || valor < 1.0 ||
+      valor > static_cast<double>(std::numeric_limits<int>::max())) {
+    return io::FormatoEntrada::kListaAristas;   // no es una N válida para la matriz
+  }
+  const long long n = static_cast<int>(valor);
+  const long long tokens_matriz = 1 + n * (n - 1) / 2;
+  if (static_cast<long long>(fin - ini) < 2 * tokens_matriz - 1) return io::FormatoEntrada::kListaAristas;
+
+  long long m = -1;
+  lector.Siguiente(token, longitud);
+  if (!ParseEntero(token, longitud, m)) m = -1;
+  long long tokens = 2;
+  while (lector.Siguiente(token, longitud)) ++tokens;
+
+  if (tokens == tokens_matriz) return io::FormatoEntrada::kTriangular;
+  if (m >= 0 && m <= tokens && tokens == 2 + 3 * m) return io::FormatoEntrada::kListaAristas;
+  return tokens > tokens_matriz ? io::FormatoEntrada::kTriangular : io::FormatoEntrada::kListaAristas;
+}
+
+/**
+ * @brief Lee una instancia desde un bloque de memoria en el formato indicado.
+ */
+io::DatosLectura LeerContenido(const char* ini, const char* fin, io::FormatoEntrada formato, int hilos) {
+  if (formato == io::FormatoEntrada::kAutomatico) formato = DetectarFormato(ini, fin);
+  if (formato == io::FormatoEntrada::kListaAristas) return LeerListaAristas(ini, fin);
+  return LeerTriangular(ini, fin, hilos);
 }
 
 /**
@@ -71,63 +475,134 @@ std::string SetToCommaList(const std::vector<int>& seq) {
 }   // namespace
 
 io::DatosLectura io::LeerFichero(const std::string& ruta) {
-  std::ifstream fichero(ruta);
-  if (!fichero.is_open()) {
-    throw std::runtime_error("No se pudo abrir el fichero: " + ruta);
-  }
-  return LeerFichero(fichero);
+  return LeerFichero(ruta, OpcionesLectura());
 } 
 
-io::DatosLectura io::LeerFichero(std::istream& in) {
-  std::string token;
+io::DatosLectura io::LeerFichero(const std::string& ruta, const OpcionesLectura& opciones) {
+  int hilos = opciones.hilos;
+  if (hilos == 0) hilos = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  if (hilos < 1) throw std::invalid_argument("El número de hilos de lectura no puede ser < 0");
 
-  // Leemos el número de vértices
-  if (!SiguienteToken(in, token)) {
-    throw std::runtime_error("Error leyendo número de vértices");
+  // Proyectamos el fichero en memoria y lo troceamos in situ, sin copiar tokens
+  const FicheroMapeado fichero(ruta);
+  if (!opciones.usar_cache) {
+    return LeerContenido(fichero.Datos(), fichero.Datos() + fichero.Tamano(), opciones.formato, hilos);
   }
-  // Convertimos a int el número de vértices
-  int num_vertices = static_cast<int>(ParseFlexibleDouble(token));
-  if (num_vertices < 1) throw std::runtime_error("Número de vértices debe ser >= 1");
-
-  Grafo grafo(num_vertices);
 
-  // Creamos una variable que determina cuantas aristas esperamos leer
-  int esperados = num_vertices * (num_vertices - 1) / 2; // Máximo número de aristas en grafo no dirigido sin bucles
-  int leidos = 0;
-
-  // Leemos las aristas
-  // Funciona asi:
-  // i = 1             | i = 2             | i = 3             | ... | i = N-1
-  // j = 2, 3, ..., N. | j = 3, 4, ..., N. | j = 4, 5, ..., N. | ... | j = N
-  // Entonces, para cada i, j comienza en i+1 y termina en N
-  for (int i = 1; i <= num_vertices - 1; ++i) {
-    for (int j = i + 1; j <= num_vertices; ++j) {
-      if (!SiguienteToken(in, token)) {
-        throw std::runtime_error("Error leyendo peso para (" + std::to_string(i) +
-                                 "," + std::to_string(j) + ")");
-      }
-      double peso = ParseFlexibleDouble(token);
-
-      if (peso < -1.0) throw std::runtime_error("Peso inválido (< -1) en (" + std::to_string(i) + "," + std::to_string(j) + ")");
-      if (peso >= 0.0) grafo.AnadirAristaNoDirigida(i, j, peso);
-
-      leidos++;
+  // Con caché: el hash recorre el fichero una vez, pero es mucho más barato que trocearlo
+  const ClaveOrigen clave{fichero.Tamano(), fichero.ModificacionNs(),
+                          checksum::Fnv1a64(fichero.Datos(), fichero.Tamano())};
+  // Cada formato tiene su propia caché: el mismo texto leído con otro --formato es otro
+  // grafo (o un error), así que nunca se sirve la caché escrita con un formato distinto
+  FormatoEntrada formato = opciones.formato;
+  if (formato == FormatoEntrada::kAutomatico) {
+    formato = DetectarFormato(fichero.Datos(), fichero.Datos() + fichero.Tamano());
+  }
+  const std::string ruta_cache =
+      ruta + (formato == FormatoEntrada::kListaAristas ? ".aristas.cache" : ".triangular.cache");
+  try {
+    if (EsGrafoBinario(ruta_cache)) {
+      ClaveOrigen guardada;
+      const GrafoCsr csr = AbrirGrafoBinario(ruta_cache, ComprobacionBinario::kCompleta, &guardada);
+      if (guardada == clave) return DatosLectura{GrafoBuilder::DesdeCsr(csr), 1, 1, Algoritmo::kBfs, {}};
     }
+  } catch (const std::exception&) {
+    // Caché corrupta o de otra versión: la reconstruimos a partir del texto
   }
 
+  DatosLectura datos = LeerContenido(fichero.Datos(), fichero.Datos() + fichero.Tamano(), formato, hilos);
 
-  // Si no hemos leido el número esperado de pesos, lanzamos error
-  if (leidos != esperados) {
-    throw std::runtime_error("Conteo de pesos incorrecto (leídos " + std::to_string(leidos) +
-                             ", esperados " + std::to_string(esperados) + ")");
+  // Escribimos a un temporal y lo renombramos, para que otro proceso nunca vea una caché a medias.
+  // Si no se puede escribir (directorio de solo lectura...), seguimos sin caché.
+  const std::string temporal = ruta_cache + ".tmp." + std::to_string(::getpid());
+  try {
+    EscribirGrafoBinario(GrafoCsr(datos.grafo), temporal, clave);
+    if (std::rename(temporal.c_str(), ruta_cache.c_str()) != 0) std::remove(temporal.c_str());
+  } catch (const std::exception&) {
+    std::remove(temporal.c_str());
   }
+  return datos;
+}
 
-  // Construimos el Problema: el resto (origen, destino, etc.) los fijarás fuera
-  io::DatosLectura problema{std::move(grafo)};
+GrafoCsr io::LeerGrafoCsr(const std::string& ruta) {
+  return GrafoCsr(LeerFichero(ruta).grafo);
+}
 
-  return problema;
+io::DatosLectura io::LeerFichero(std::istream& in) {
+  // Un stream no se puede proyectar: lo volcamos entero a memoria una sola vez
+  const std::string contenido((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  return LeerContenido(contenido.data(), contenido.data() + contenido.size(), FormatoEntrada::kAutomatico, 1);
+}
+
+
+io::Algoritmo io::AlgoritmoDesdeNombre(const std::string& nombre) {
+  if (nombre == "bfs") return Algoritmo::kBfs;
+  if (nombre == "dfs") return Algoritmo::kDfs;
+  if (nombre == "ucs") return Algoritmo::kUcs;
+  if (nombre == "bidir") return Algoritmo::kBidireccional;
+  if (nombre == "iddfs") return Algoritmo::kIddfs;
+  if (nombre == "bfs-par") return Algoritmo::kBfsParalelo;
+  if (nombre == "dfs-par") return Algoritmo::kDfsParalelo;
+  if (nombre == "yen") return Algoritmo::kYen;
+  throw std::runtime_error("Algoritmo desconocido: " + nombre);
+}
+
+std::string io::NombreAlgoritmo(Algoritmo algoritmo) {
+  switch (algoritmo) {
+    case Algoritmo::kBfs: return "bfs";
+    case Algoritmo::kDfs: return "dfs";
+    case Algoritmo::kUcs: return "ucs";
+    case Algoritmo::kBidireccional: return "bidir";
+    case Algoritmo::kIddfs: return "iddfs";
+    case Algoritmo::kBfsParalelo: return "bfs-par";
+    case Algoritmo::kDfsParalelo: return "dfs-par";
+    case Algoritmo::kYen: return "yen";
+  }
+  return "?";
 }
 
+void io::ComprobarOpciones(Algoritmo algoritmo, const trace::OpcionesBusqueda& opts) {
+  bool admite_k = false;
+  bool admite_parar = true;
+  bool admite_en_grafo = true;
+  switch (algoritmo) {
+    case Algoritmo::kBfs:
+    case Algoritmo::kDfs:
+    case Algoritmo::kDfsParalelo:
+      admite_k = true;
+      break;
+    case Algoritmo::kYen:
+      // Solo usa k: siempre calcula los k caminos, cada uno con un Dijkstra en grafo
+      admite_k = true;
+      admite_parar = false;
+      admite_en_grafo = false;
+      break;
+    case Algoritmo::kBidireccional:
+      // Para siempre en el primer encuentro de las dos fronteras, que son búsquedas en grafo
+      admite_parar = false;
+      admite_en_grafo = false;
+      break;
+    case Algoritmo::kUcs:
+    case Algoritmo::kBfsParalelo:
+      // Son siempre búsqueda en grafo: --en-grafo no cambiaría nada
+      admite_en_grafo = false;
+      break;
+    case Algoritmo::kIddfs:
+      // Es búsqueda en árbol por diseño (memoria O(profundidad), sin conjunto de cerrados)
+      admite_en_grafo = false;
+      break;
+  }
+  const std::string nombre = NombreAlgoritmo(algoritmo);
+  if (opts.k_mejores > 0 && !admite_k) {
+    throw std::runtime_error("El algoritmo " + nombre + " no admite --k");
+  }
+  if (opts.parar_a_primera_solucion && !admite_parar) {
+    throw std::runtime_error("El algoritmo " + nombre + " no admite --parar");
+  }
+  if (opts.busqueda_en_grafo && !admite_en_grafo) {
+    throw std::runtime_error("El algoritmo " + nombre + " no admite --en-grafo");
+  }
+}
 
 void io::ImprimirTraza(std::ostream& out, const trace::ResultadoBusqueda& r, bool acumulada) {
   size_t acc_inspected = 0, acc_generated = 0;
@@ -173,6 +648,40 @@ void io::ImprimirSolucion(std::ostream& out, const trace::ResultadoBusqueda& r)
   out.unsetf(std::ios::fixed);
 }
 
+void io::ImprimirMejoresSoluciones(std::ostream& out, const trace::ResultadoBusqueda& r) {
+  if (r.mejores.empty()) return;
+  out << "Mejores soluciones (" << r.mejores.size() << "):\n";
+  out.setf(std::ios::fixed);
+  for (size_t k = 0; k < r.mejores.size(); ++k) {
+    out << "  " << k + 1 << ". ";
+    for (size_t i = 0; i < r.mejores[k].camino.size(); ++i) {
+      if (i) out << " -> ";
+      out << r.mejores[k].camino[i];
+    }
+    out << " (coste " << std::setprecision(2) << r.mejores[k].coste << ")\n";
+  }
+  out.unsetf(std::ios::fixed);
+}
+
+void io::ImprimirCaminos(std::ostream& out, const trace::ArbolCaminos& caminos) {
+  const int n = static_cast<int>(caminos.padre.size()) - 1;
+  out.setf(std::ios::fixed);
+  for (int v = 1; v <= n; ++v) {
+    out << "Destino " << v << ": ";
+    const trace::ResultadoBusqueda r = caminos.ExtraerCamino(v);
+    if (!r.found) {
+      out << "sin camino\n";
+      continue;
+    }
+    for (size_t i = 0; i < r.camino.size(); ++i) {
+      if (i) out << " -> ";
+      out << r.camino[i];
+    }
+    out << " (coste " << std::setprecision(2) << r.coste_total << ")\n";
+  }
+  out.unsetf(std::ios::fixed);
+}
+
 void io::ImprimirResumen(std::ostream& out, const trace::ResultadoBusqueda& r) {
   out << "-----------------------------------------\n";
   out << "Resumen\n";
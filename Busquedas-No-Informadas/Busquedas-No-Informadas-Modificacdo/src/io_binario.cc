@@ -0,0 +1,180 @@
+#include "io.h"
+#include "checksum.h"
+#include "fichero_mapeado.h"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+/**
+ * @brief Cabecera del formato binario (64 bytes, en el orden de bytes de la máquina).
+ *
+ * Tras la cabecera van, sin huecos salvo el relleno indicado:
+ *   - offsets: (N+1) x uint64
+ *   - ids:     E x int32, más 4 bytes de relleno si E es impar (para alinear a 8)
+ *   - pesos:   E x double
+ * donde E = num_entradas = 2 * aristas. Todas las secciones empiezan alineadas a
+ * 8 bytes respecto al inicio del fichero, así que se pueden usar directamente
+ * sobre la proyección en memoria (mmap siempre empieza en frontera de página).
+ *
+ * checksum es el hash (checksum::Fnv1a64) de todo lo que va detrás de la cabecera.
+ * origen identifica el fichero de texto del que sale el grafo cuando se usa como caché.
+ */
+struct CabeceraBinaria {
+  char magia[8];               ///< "GRAFOCSR"
+  std::uint32_t version;       ///< Versión del formato (kVersion).
+  std::uint32_t marca_orden;   ///< kMarcaOrden; si no coincide, el fichero es de otra arquitectura.
+  std::uint64_t num_vertices;  ///< N.
+  std::uint64_t num_entradas;  ///< E (2 * aristas).
+  std::uint64_t checksum;      ///< Hash de la carga útil.
+  std::uint64_t origen[3];     ///< io::ClaveOrigen del texto de origen (tamaño, mtime, hash), o ceros.
+};
+static_assert(sizeof(CabeceraBinaria) == 64, "La cabecera binaria debe ocupar 64 bytes");
+
+constexpr char kMagia[8] = {'G', 'R', 'A', 'F', 'O', 'C', 'S', 'R'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kMarcaOrden = 0x01020304;
+
+/**
+ * @brief Posición (en bytes desde el inicio del fichero) de cada sección.
+ */
+struct Secciones {
+  std::uint64_t offsets;
+  std::uint64_t ids;
+  std::uint64_t pesos;
+  std::uint64_t fin;   ///< Tamaño total del fichero.
+};
+
+Secciones CalcularSecciones(std::uint64_t num_vertices, std::uint64_t num_entradas) {
+  Secciones s;
+  s.offsets = sizeof(CabeceraBinaria);
+  s.ids = s.offsets + (num_vertices + 1) * sizeof(std::uint64_t);
+  // Rellenamos los ids hasta múltiplo de 8 para que los pesos queden alineados
+  const std::uint64_t bytes_ids = num_entradas * sizeof(std::int32_t);
+  s.pesos = s.ids + ((bytes_ids + 7) / 8) * 8;
+  s.fin = s.pesos + num_entradas * sizeof(double);
+  return s;
+}
+}  // namespace
+
+void io::EscribirGrafoBinario(const GrafoCsr& grafo, const std::string& ruta, const ClaveOrigen& clave) {
+  const std::uint64_t n = static_cast<std::uint64_t>(grafo.GetNumVertices());
+  const std::uint64_t e = grafo.GetNumEntradas();
+  const Secciones secciones = CalcularSecciones(n, e);
+
+  const std::size_t bytes_offsets = static_cast<std::size_t>((n + 1) * sizeof(std::uint64_t));
+  const std::size_t bytes_ids = static_cast<std::size_t>(e * sizeof(std::int32_t));
+  const std::size_t relleno = static_cast<std::size_t>(secciones.pesos - secciones.ids) - bytes_ids;
+  const std::size_t bytes_pesos = static_cast<std::size_t>(e * sizeof(double));
+  const char ceros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+  // Las secciones miden múltiplos de 8 bytes (ids con su relleno), así que el hash se puede encadenar
+  std::uint64_t h = checksum::Fnv1a64(grafo.GetOffsets(), bytes_offsets);
+  h = checksum::Fnv1a64(grafo.GetIds(), bytes_ids, h);
+  h = checksum::Fnv1a64(ceros, relleno, h);
+  h = checksum::Fnv1a64(grafo.GetPesos(), bytes_pesos, h);
+
+  CabeceraBinaria cabecera;
+  std::memset(&cabecera, 0, sizeof(cabecera));
+  std::memcpy(cabecera.magia, kMagia, sizeof(kMagia));
+  cabecera.version = kVersion;
+  cabecera.marca_orden = kMarcaOrden;
+  cabecera.num_vertices = n;
+  cabecera.num_entradas = e;
+  cabecera.checksum = h;
+  cabecera.origen[0] = clave.tamano;
+  cabecera.origen[1] = clave.modificacion_ns;
+  cabecera.origen[2] = clave.hash;
+
+  std::ofstream out(ruta, std::ios::binary | std::ios::trunc);
+  if (!out) throw std::runtime_error("No se pudo crear el fichero binario: " + ruta);
+  out.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+  out.write(reinterpret_cast<const char*>(grafo.GetOffsets()), static_cast<std::streamsize>(bytes_offsets));
+  out.write(reinterpret_cast<const char*>(grafo.GetIds()), static_cast<std::streamsize>(bytes_ids));
+  out.write(ceros, static_cast<std::streamsize>(relleno));
+  out.write(reinterpret_cast<const char*>(grafo.GetPesos()), static_cast<std::streamsize>(bytes_pesos));
+  if (!out) throw std::runtime_error("Error escribiendo el fichero binario: " + ruta);
+}
+
+bool io::EsGrafoBinario(const std::string& ruta) {
+  std::ifstream in(ruta, std::ios::binary);
+  char magia[sizeof(kMagia)];
+  if (!in.read(magia, sizeof(magia))) return false;
+  return std::memcmp(magia, kMagia, sizeof(kMagia)) == 0;
+}
+
+GrafoCsr io::AbrirGrafoBinario(const std::string& ruta, ComprobacionBinario comprobacion, ClaveOrigen* clave) {
+  auto mapeo = std::make_shared<const FicheroMapeado>(ruta);
+  const char* base = mapeo->Datos();
+  const std::uint64_t tamano = mapeo->Tamano();
+
+  // Comprobaciones O(1) de la cabecera y de los offsets extremos: siempre se hacen
+  if (tamano < sizeof(CabeceraBinaria)) throw std::runtime_error("Fichero binario demasiado corto: " + ruta);
+  CabeceraBinaria cabecera;
+  std::memcpy(&cabecera, base, sizeof(cabecera));
+  if (std::memcmp(cabecera.magia, kMagia, sizeof(kMagia)) != 0) {
+    throw std::runtime_error("No es un grafo binario: " + ruta);
+  }
+  if (cabecera.version != kVersion) {
+    throw std::runtime_error("Versión de grafo binario no soportada (" + std::to_string(cabecera.version) + "): " + ruta);
+  }
+  if (cabecera.marca_orden != kMarcaOrden) {
+    throw std::runtime_error("Grafo binario escrito con otro orden de bytes: " + ruta);
+  }
+  if (cabecera.num_vertices < 1 ||
+      cabecera.num_vertices > static_cast<std::uint64_t>(std::numeric_limits<std::int32_t>::max())) {
+    throw std::runtime_error("Número de vértices inválido en el grafo binario: " + ruta);
+  }
+  // Cada entrada ocupa al menos 12 bytes (id + peso): con esta cota los tamaños de las
+  // secciones no pueden desbordar y una cabecera manipulada no da la vuelta al cálculo
+  if (cabecera.num_entradas > tamano / (sizeof(std::int32_t) + sizeof(double))) {
+    throw std::runtime_error("Número de entradas inválido en el grafo binario: " + ruta);
+  }
+  const Secciones secciones = CalcularSecciones(cabecera.num_vertices, cabecera.num_entradas);
+  if (secciones.fin != tamano) throw std::runtime_error("Tamaño del grafo binario incorrecto: " + ruta);
+
+  const auto* offsets = reinterpret_cast<const std::uint64_t*>(base + secciones.offsets);
+  const auto* ids = reinterpret_cast<const std::int32_t*>(base + secciones.ids);
+  const auto* pesos = reinterpret_cast<const double*>(base + secciones.pesos);
+  if (offsets[0] != 0 || offsets[cabecera.num_vertices] != cabecera.num_entradas) {
+    throw std::runtime_error("Offsets extremos incorrectos en el grafo binario: " + ruta);
+  }
+
+  if (comprobacion == ComprobacionBinario::kCompleta) {
+    const std::uint64_t h = checksum::Fnv1a64(base + sizeof(CabeceraBinaria), tamano - sizeof(CabeceraBinaria));
+    if (h != cabecera.checksum) throw std::runtime_error("Checksum incorrecto en el grafo binario: " + ruta);
+  }
+
+  // Comprobaciones O(N + M) de la estructura: salvo que se pida explícitamente no hacerlas,
+  // porque GetVecinosSinComprobar y las marcas por vértice usan offsets e ids sin mirar el rango
+  if (comprobacion != ComprobacionBinario::kCabecera) {
+    const std::int64_t n = static_cast<std::int64_t>(cabecera.num_vertices);
+    for (std::int64_t v = 0; v < n; ++v) {
+      if (offsets[v] > offsets[v + 1]) throw std::runtime_error("Offsets no crecientes en el grafo binario: " + ruta);
+    }
+    for (std::uint64_t k = 0; k < cabecera.num_entradas; ++k) {
+      if (ids[k] < 1 || ids[k] > n || pesos[k] < 0.0) {
+        throw std::runtime_error("Arista inválida en el grafo binario: " + ruta);
+      }
+    }
+    // GetPesoArista busca en binario dentro de cada fila: los ids tienen que ir en orden estricto
+    for (std::int64_t v = 0; v < n; ++v) {
+      for (std::uint64_t k = offsets[v] + 1; k < offsets[v + 1]; ++k) {
+        if (ids[k - 1] >= ids[k]) throw std::runtime_error("Fila de vecinos desordenada en el grafo binario: " + ruta);
+      }
+    }
+  }
+
+  if (clave != nullptr) {
+    clave->tamano = cabecera.origen[0];
+    clave->modificacion_ns = cabecera.origen[1];
+    clave->hash = cabecera.origen[2];
+  }
+
+  return GrafoCsr(std::move(mapeo), static_cast<int>(cabecera.num_vertices), cabecera.num_entradas,
+                  offsets, ids, pesos);
+}
@@ -0,0 +1,260 @@
+#include "lote.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+// Convierte un token entero completo (sin restos), o lanza con la línea en el mensaje
+// ('que' es lo que se esperaba, para el mensaje)
+int ParseEnteroConsulta(const std::string& token, int linea, const char* que = "un vértice") {
+  int valor = 0;
+  const char* fin = token.data() + token.size();
+  const auto r = std::from_chars(token.data(), fin, valor);
+  if (r.ec != std::errc() || r.ptr != fin) {
+    throw std::runtime_error("Consulta inválida en la línea " + std::to_string(linea) + ": '" + token +
+                             "' no es " + que);
+  }
+  return valor;
+}
+
+template <typename G>
+trace::ResultadoBusqueda BuscarImpl(busqueda& busq, const G& g, const lote::Consulta& c) {
+  if (!c.error.empty()) throw std::runtime_error(c.error);
+  switch (c.algoritmo) {
+    case io::Algoritmo::kBfs: return busq.BfsModi(g, c.origen, c.destino, c.opts);
+    case io::Algoritmo::kDfs: return busq.Dfs(g, c.origen, c.destino, c.opts);
+    case io::Algoritmo::kUcs: return busq.Ucs(g, c.origen, c.destino, c.opts);
+    case io::Algoritmo::kBidireccional: return busq.BfsBidireccional(g, c.origen, c.destino, c.opts);
+    case io::Algoritmo::kIddfs: return busq.Iddfs(g, c.origen, c.destino, c.opts);
+    case io::Algoritmo::kBfsParalelo: return busq.BfsParalelo(g, c.origen, c.destino, c.opts, c.hilos);
+    case io::Algoritmo::kDfsParalelo: return busq.DfsParalelo(g, c.origen, c.destino, c.opts, c.hilos);
+    case io::Algoritmo::kYen:
+      return busq.KCaminosMasCortos(g, c.origen, c.destino, std::max<std::size_t>(1, c.opts.k_mejores));
+  }
+  throw std::logic_error("Algoritmo no contemplado");
+}
+
+// Escribe el bloque de resultado de una consulta (o su error)
+void EscribirBloque(std::ostream& out, std::size_t numero, const lote::Consulta& c,
+                    const trace::ResultadoBusqueda* resultado, const std::string& error, bool traza) {
+  out << "-----------------------------------------\n";
+  if (!c.error.empty()) {
+    // Línea mal formada: no hay origen, destino ni algoritmo fiables que mostrar
+    out << "Consulta " << numero << " (línea " << c.linea << "): inválida\n";
+    out << "Error: " << c.error << "\n";
+    return;
+  }
+  out << "Consulta " << numero << " (línea " << c.linea << "): origen " << c.origen << ", destino " << c.destino
+      << ", algoritmo " << io::NombreAlgoritmo(c.algoritmo) << "\n";
+  if (resultado == nullptr) {
+    out << "Error: " << error << "\n";
+    return;
+  }
+  if (traza) io::ImprimirTrazaEstiloGuion(out, *resultado, c.origen);
+  io::ImprimirSolucion(out, *resultado);
+  io::ImprimirMejoresSoluciones(out, *resultado);
+  io::ImprimirResumen(out, *resultado);
+}
+
+// Resuelve una consulta y escribe su bloque en out. Devuelve true si la consulta falló.
+template <typename G>
+bool ResolverConsulta(busqueda& busq, const G& g, std::size_t numero, const lote::Consulta& c,
+                      std::ostream& out, bool traza) {
+  try {
+    const trace::ResultadoBusqueda resultado = BuscarImpl(busq, g, c);
+    EscribirBloque(out, numero, c, &resultado, "", traza);
+    return false;
+  } catch (const std::exception& e) {
+    EscribirBloque(out, numero, c, nullptr, e.what(), traza);
+    return true;
+  }
+}
+
+// Resuelve las consultas con varios hilos y escribe los bloques en orden. Devuelve el
+// número de consultas que fallaron.
+template <typename G>
+std::size_t EjecutarEnParalelo(const G& g, const std::vector<lote::Consulta>& consultas, std::ostream& out,
+                               bool traza, std::size_t hilos) {
+  const std::size_t n = consultas.size();
+
+  // Ventana circular de bloques formateados: un hilo no empieza la consulta k hasta que
+  // se ha escrito la k - ventana, así la memoria no crece aunque una consulta lenta
+  // retrase la escritura de las siguientes
+  const std::size_t ventana = std::max<std::size_t>(64, 16 * hilos);
+  std::vector<std::string> bloques(ventana);
+  std::vector<char> listo(ventana, 0);
+  std::size_t escritos = 0;  // protegido por m
+  std::mutex m;
+  std::condition_variable hay_bloque;  // avisa al escritor de que hay un bloque listo
+  std::condition_variable hay_hueco;   // avisa a los hilos de que la ventana ha avanzado
+
+  std::atomic<std::size_t> siguiente{0};
+  std::atomic<std::size_t> errores{0};
+
+  auto trabajador = [&]() {
+    // Cada hilo tiene su propio objeto busqueda: sus buffers se reutilizan entre sus consultas
+    busqueda busq;
+    std::ostringstream bloque;
+    while (true) {
+      const std::size_t k = siguiente.fetch_add(1, std::memory_order_relaxed);
+      if (k >= n) return;
+      {
+        std::unique_lock<std::mutex> lock(m);
+        hay_hueco.wait(lock, [&] { return k < escritos + ventana; });
+      }
+
+      bloque.str("");
+      if (ResolverConsulta(busq, g, k + 1, consultas[k], bloque, traza)) {
+        errores.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(m);
+        bloques[k % ventana] = bloque.str();
+        listo[k % ventana] = 1;
+      }
+      hay_bloque.notify_one();
+    }
+  };
+
+  std::vector<std::thread> trabajadores;
+  trabajadores.reserve(hilos);
+  for (std::size_t t = 0; t < hilos; ++t) trabajadores.emplace_back(trabajador);
+
+  // El hilo llamador es el único que escribe en 'out', en el orden de las consultas
+  std::string bloque;
+  for (std::size_t k = 0; k < n; ++k) {
+    {
+      std::unique_lock<std::mutex> lock(m);
+      hay_bloque.wait(lock, [&] { return listo[k % ventana] != 0; });
+      bloque.swap(bloques[k % ventana]);
+      listo[k % ventana] = 0;
+      ++escritos;
+    }
+    hay_hueco.notify_all();
+    out << bloque;
+  }
+
+  for (auto& t : trabajadores) t.join();
+  return errores.load();
+}
+
+template <typename G>
+lote::EstadisticasLote EjecutarLoteImpl(const G& g, const std::vector<lote::Consulta>& consultas,
+                                        std::ostream& out, const lote::OpcionesLote& opciones) {
+  int hilos = opciones.hilos;
+  if (hilos == 0) hilos = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  if (hilos < 1) throw std::invalid_argument("El número de hilos del lote no puede ser < 0");
+
+  lote::EstadisticasLote estadisticas;
+  estadisticas.hilos =
+      std::min<std::size_t>(static_cast<std::size_t>(hilos), std::max<std::size_t>(1, consultas.size()));
+  const auto inicio = std::chrono::steady_clock::now();
+
+  if (estadisticas.hilos == 1) {
+    // Un único objeto de búsqueda: sus marcas y montículos se reutilizan entre consultas
+    busqueda busq;
+    for (std::size_t k = 0; k < consultas.size(); ++k) {
+      if (ResolverConsulta(busq, g, k + 1, consultas[k], out, opciones.traza)) ++estadisticas.errores;
+    }
+  } else {
+    estadisticas.errores = EjecutarEnParalelo(g, consultas, out, opciones.traza, estadisticas.hilos);
+  }
+  estadisticas.consultas = consultas.size();
+  out.flush();
+
+  estadisticas.segundos =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+  return estadisticas;
+}
+}  // namespace
+
+std::vector<lote::Consulta> lote::LeerConsultas(const std::string& ruta) {
+  std::ifstream in(ruta);
+  if (!in) throw std::runtime_error("No se pudo abrir el fichero de consultas: " + ruta);
+  return LeerConsultas(in);
+}
+
+std::vector<lote::Consulta> lote::LeerConsultas(std::istream& in) {
+  std::vector<Consulta> consultas;
+  std::string linea;
+  int num_linea = 0;
+  while (std::getline(in, linea)) {
+    ++num_linea;
+    std::istringstream ss(linea);
+    std::string origen, destino, algoritmo;
+    if (!(ss >> origen)) continue;              // línea vacía
+    if (origen[0] == '#') continue;             // comentario
+
+    Consulta c;
+    c.linea = num_linea;
+    // Una línea mal formada no aborta el lote: queda como consulta con error y su
+    // bloque lo recoge al ejecutarlo, igual que una consulta que falla al buscar
+    try {
+      if (!(ss >> destino >> algoritmo)) {
+        throw std::runtime_error("Consulta incompleta en la línea " + std::to_string(num_linea) +
+                                 " (se espera '<origen> <destino> <algoritmo> [opciones]')");
+      }
+      c.origen = ParseEnteroConsulta(origen, num_linea);
+      c.destino = ParseEnteroConsulta(destino, num_linea);
+      c.algoritmo = io::AlgoritmoDesdeNombre(algoritmo);
+      c.opts.parar_a_primera_solucion = false;
+
+      std::string opcion;
+      while (ss >> opcion) {
+        std::string valor;
+        if (opcion == "--parar") c.opts.parar_a_primera_solucion = true;
+        else if (opcion == "--en-grafo") c.opts.busqueda_en_grafo = true;
+        else if (opcion == "--k" && ss >> valor) {
+          const int k = ParseEnteroConsulta(valor, num_linea, "un número de soluciones");
+          if (k < 0) {
+            throw std::runtime_error("Consulta inválida en la línea " + std::to_string(num_linea) + ": --k negativo");
+          }
+          c.opts.k_mejores = static_cast<size_t>(k);
+        } else if (opcion == "--k") {
+          throw std::runtime_error("Consulta inválida en la línea " + std::to_string(num_linea) + ": --k sin valor");
+        } else {
+          throw std::runtime_error("Opción desconocida en la línea " + std::to_string(num_linea) + ": " + opcion);
+        }
+      }
+      try {
+        io::ComprobarOpciones(c.algoritmo, c.opts);
+      } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Consulta inválida en la línea " + std::to_string(num_linea) + ": " + e.what());
+      }
+    } catch (const std::runtime_error& e) {
+      c = Consulta();
+      c.linea = num_linea;
+      c.error = e.what();
+    }
+    consultas.push_back(c);
+  }
+  return consultas;
+}
+
+trace::ResultadoBusqueda lote::Buscar(busqueda& busq, const Grafo& g, const Consulta& consulta) {
+  return BuscarImpl(busq, g, consulta);
+}
+
+trace::ResultadoBusqueda lote::Buscar(busqueda& busq, const GrafoCsr& g, const Consulta& consulta) {
+  return BuscarImpl(busq, g, consulta);
+}
+
+lote::EstadisticasLote lote::EjecutarLote(const Grafo& g, const std::vector<Consulta>& consultas,
+                                          std::ostream& out, const OpcionesLote& opciones) {
+  return EjecutarLoteImpl(g, consultas, out, opciones);
+}
+
+lote::EstadisticasLote lote::EjecutarLote(const GrafoCsr& g, const std::vector<Consulta>& consultas,
+                                          std::ostream& out, const OpcionesLote& opciones) {
+  return EjecutarLoteImpl(g, consultas, out, opciones);
+}
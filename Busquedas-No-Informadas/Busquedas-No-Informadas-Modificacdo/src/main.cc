@@ -1,34 +1,214 @@
 #include "io.h"
 #include "busqueda.h"
+#include "lote.h"
 
+#include <charconv>
 #include <iostream>
 #include <fstream>
+#include <iomanip>
+#include <stdexcept>
 #include <string>
 
+namespace {
+/**
+ * @brief Lanza el algoritmo pedido sobre cualquier representación del grafo (Grafo o GrafoCsr).
+ */
+template <typename G>
+trace::ResultadoBusqueda Buscar(busqueda& busq, const G& grafo, const io::DatosLectura& datos, int hilos) {
+  lote::Consulta consulta;
+  consulta.origen = datos.origen;
+  consulta.destino = datos.destino;
+  consulta.algoritmo = datos.algoritmo;
+  consulta.opts = datos.opts;
+  consulta.hilos = hilos;
+  return lote::Buscar(busq, grafo, consulta);
+}
+
+/**
+ * @brief Convierte el valor de --k con la misma comprobación que el modo lote: el token
+ *        entero tiene que ser un número (sin restos como en "3abc") y no negativo.
+ * @throw std::invalid_argument Si el valor no es válido.
+ */
+int ParseKMejores(const std::string& token) {
+  int k = 0;
+  const char* fin = token.data() + token.size();
+  const auto r = std::from_chars(token.data(), fin, k);
+  if (r.ec != std::errc() || r.ptr != fin) {
+    throw std::invalid_argument("--k: '" + token + "' no es un número de soluciones");
+  }
+  if (k < 0) throw std::invalid_argument("--k no puede ser negativo");
+  return k;
+}
+
+/**
+ * @brief Lee las opciones de lectura (--hilos, --formato, --cache, --verificar, --sin-comprobar) a partir de argv[i].
+ * @return true si argv[i] era una opción de lectura (y avanza i si tenía valor).
+ */
+bool LeerOpcionLectura(int argc, char* argv[], int& i, io::OpcionesLectura& opciones) {
+  std::string arg = argv[i];
+  if (arg == "--hilos" && i + 1 < argc) {
+    opciones.hilos = std::stoi(argv[i + 1]);
+    ++i;
+    return true;
+  }
+  if (arg == "--cache") {
+    opciones.usar_cache = true;
+    return true;
+  }
+  if (arg == "--verificar") {
+    opciones.comprobacion = io::ComprobacionBinario::kCompleta;
+    return true;
+  }
+  if (arg == "--sin-comprobar") {
+    opciones.comprobacion = io::ComprobacionBinario::kCabecera;
+    return true;
+  }
+  if (arg == "--formato" && i + 1 < argc) {
+    std::string formato = argv[i + 1];
+    if (formato == "triangular") opciones.formato = io::FormatoEntrada::kTriangular;
+    else if (formato == "aristas") opciones.formato = io::FormatoEntrada::kListaAristas;
+    else throw std::runtime_error("Formato desconocido: " + formato);
+    ++i;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Subcomando convertir: lee un grafo en texto y lo guarda en formato binario.
+ */
+int Convertir(int argc, char* argv[]) {
+  if (argc < 4) {
+    std::cerr << "Uso: " << argv[0]
+              << " convertir <fichero_grafo> <fichero_binario> [--hilos <n>] [--formato <triangular|aristas>]\n";
+    return 1;
+  }
+  try {
+    io::OpcionesLectura opciones_lectura;
+    for (int i = 4; i < argc; ++i) LeerOpcionLectura(argc, argv, i, opciones_lectura);
+
+    const GrafoCsr grafo(io::LeerFichero(argv[2], opciones_lectura).grafo);
+    io::EscribirGrafoBinario(grafo, argv[3]);
+    std::cout << "Grafo binario escrito en " << argv[3] << " (" << grafo.GetNumVertices()
+              << " vértices, " << grafo.GetNumAristas() << " aristas)\n";
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Subcomando lote: carga el grafo una vez y resuelve todas las consultas de un fichero.
+ */
+int Lote(int argc, char* argv[]) {
+  if (argc < 4) {
+    std::cerr << "Uso: " << argv[0]
+              <<  " lote <fichero_grafo> <fichero_consultas> [--csr] [--traza] [--hilos <n>] [--formato <triangular|aristas>] [--cache] [--verificar|--sin-comprobar] [--out <fichero_salida>]\n"
+              << "     Cada línea de consultas: <origen> <destino> <algoritmo> [--parar] [--en-grafo] [--k <n>]\n";
+    return 1;
+  }
+  try {
+    const std::string fichero_grafo = argv[2];
+    io::OpcionesLectura opciones_lectura;
+    lote::OpcionesLote opciones;
+    bool csr = false;
+    std::string fichero_salida = "salida.txt";
+    for (int i = 4; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (LeerOpcionLectura(argc, argv, i, opciones_lectura)) continue;
+      if (arg == "--csr") csr = true;
+      else if (arg == "--traza") opciones.traza = true;
+      else if (arg == "--out" && i + 1 < argc) {
+        fichero_salida = argv[i + 1];
+        ++i;
+      }
+    }
+
+    // --hilos vale tanto para la carga del grafo como para resolver las consultas
+    opciones.hilos = opciones_lectura.hilos;
+    const std::vector<lote::Consulta> consultas = lote::LeerConsultas(argv[3]);
+
+    std::ofstream fout(fichero_salida);
+    if (!fout) throw std::runtime_error("No se pudo abrir fichero de salida: " + fichero_salida);
+
+    // El grafo se carga una sola vez para todas las consultas
+    lote::EstadisticasLote estadisticas;
+    if (io::EsGrafoBinario(fichero_grafo)) {
+      const GrafoCsr grafo = io::AbrirGrafoBinario(fichero_grafo, opciones_lectura.comprobacion);
+      estadisticas = lote::EjecutarLote(grafo, consultas, fout, opciones);
+    } else {
+      const Grafo grafo = io::LeerFichero(fichero_grafo, opciones_lectura).grafo;
+      if (csr) estadisticas = lote::EjecutarLote(GrafoCsr(grafo), consultas, fout, opciones);
+      else estadisticas = lote::EjecutarLote(grafo, consultas, fout, opciones);
+    }
+
+    const double por_segundo = estadisticas.segundos > 0 ? estadisticas.consultas / estadisticas.segundos : 0.0;
+    std::cout << estadisticas.consultas << " consultas (" << estadisticas.errores << " con error) en "
+              << std::fixed << std::setprecision(3) << estadisticas.segundos << " s: "
+              << std::setprecision(1) << por_segundo << " consultas/s (" << estadisticas.hilos << " hilos)\n";
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
+}  // namespace
+
 int main(int argc, char* argv[]) {
+  if (argc >= 2 && std::string(argv[1]) == "convertir") return Convertir(argc, argv);
+  if (argc >= 2 && std::string(argv[1]) == "lote") return Lote(argc, argv);
+
   if (argc < 5) {
     std::cerr << "Uso: " << argv[0]
-              << " <fichero_grafo> <origen> <destino> <algoritmo: bfs|dfs> [--acumulada] [--parar] [--out <fichero_salida>]\n";
+              << " <fichero_grafo> <origen> <destino|todos> <algoritmo: bfs|dfs|ucs|bidir|iddfs|bfs-par|dfs-par|yen> [--acumulada] [--parar] [--en-grafo] [--k <n>] [--csr] [--hilos <n>] [--formato <triangular|aristas>] [--cache] [--verificar|--sin-comprobar] [--out <fichero_salida>]\n"
+              << "     " << argv[0]
+              << " convertir <fichero_grafo> <fichero_binario> [--hilos <n>] [--formato <triangular|aristas>]\n"
+              << "     " << argv[0]
+              <<  " lote <fichero_grafo> <fichero_consultas> [--csr] [--traza] [--hilos <n>] [--formato <triangular|aristas>] [--cache] [--verificar|--sin-comprobar] [--out <fichero_salida>]\n"
+              << "     Con destino 'todos' (solo con bfs) se hace una única BFS en grafo (cola FIFO, cada vértice\n"
+              << "     se genera una sola vez) y se imprime el camino a cada vértice. Su traza no es la de bfs\n"
+              << "     hacia un destino concreto, y no admite --parar, --en-grafo ni --k.\n"
+              << "     --k solo lo usan bfs, dfs, dfs-par y yen; --en-grafo, bfs, dfs y dfs-par, y --parar\n"
+              << "     todos salvo bidir y yen. Una opción que el algoritmo no usa es un error.\n";
     return 1;
   }
 
   std::string fichero_grafo = argv[1];
   int origen = std::stoi(argv[2]);
-  int destino = std::stoi(argv[3]);
+  // Con destino "todos" se hace una sola BFS desde el origen y se imprime el camino a cada vértice
+  const bool todos = std::string(argv[3]) == "todos";
+  int destino = todos ? 0 : std::stoi(argv[3]);
   std::string alg_str = argv[4];
   std::string fichero_salida = "salida.txt";
 
   bool acumulada = false;
   bool parar = false;
+  bool en_grafo = false;
+  bool csr = false;
+  int k_mejores = 0;
+  io::OpcionesLectura opciones_lectura;
 
-  for (int i = 5; i < argc; ++i) {
-    std::string arg = argv[i];
-    if (arg == "--acumulada") acumulada = true;
-    else if (arg == "--parar") parar = true;
-    else if (arg == "--out" && i + 1 < argc) {
-      fichero_salida = argv[i + 1];
-      ++i;
+  try {
+    for (int i = 5; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (arg == "--acumulada") acumulada = true;
+      else if (arg == "--parar") parar = true;
+      else if (arg == "--en-grafo") en_grafo = true;
+      else if (arg == "--csr") csr = true;
+      else if (arg == "--k" && i + 1 < argc) {
+        k_mejores = ParseKMejores(argv[i + 1]);
+        ++i;
+      }
+      else if (LeerOpcionLectura(argc, argv, i, opciones_lectura)) continue;
+      else if (arg == "--out" && i + 1 < argc) {
+        fichero_salida = argv[i + 1];
+        ++i;
+      }
     }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
   }
 
   std::ofstream fout(fichero_salida);
@@ -40,41 +220,71 @@ int main(int argc, char* argv[]) {
   busqueda busq;
 
   try {
-    io::DatosLectura datos = io::LeerFichero(fichero_grafo);
-    datos.origen = origen;
-    datos.destino = destino;
+    // Los grafos binarios se proyectan en memoria y se buscan directamente en CSR
+    const bool binario = io::EsGrafoBinario(fichero_grafo);
+
+    io::DatosLectura datos{Grafo(1), origen, destino, io::Algoritmo::kBfs, {}};
+    if (!binario) datos.grafo = io::LeerFichero(fichero_grafo, opciones_lectura).grafo;
     datos.opts.parar_a_primera_solucion = parar;
+    datos.opts.busqueda_en_grafo = en_grafo;
+    datos.opts.k_mejores = static_cast<size_t>(k_mejores);
+
+    datos.algoritmo = io::AlgoritmoDesdeNombre(alg_str);
+    if (todos && datos.algoritmo != io::Algoritmo::kBfs) {
+      throw std::runtime_error("El destino 'todos' solo está disponible con bfs");
+    }
+    if (todos && (parar || en_grafo || k_mejores > 0)) {
+      throw std::runtime_error("El destino 'todos' no admite --parar, --en-grafo ni --k");
+    }
+    io::ComprobarOpciones(datos.algoritmo, datos.opts);
 
-    if (alg_str == "bfs") datos.algoritmo = io::Algoritmo::kBfs;
-    else if (alg_str == "dfs") datos.algoritmo = io::Algoritmo::kDfs;
-    else throw std::runtime_error("Algoritmo desconocido: " + alg_str);
+    int n = 0;
+    size_t m = 0;
 
     trace::ResultadoBusqueda resultado;
-    if (datos.algoritmo == io::Algoritmo::kBfs) {
-      resultado = busq.BfsModi(datos.grafo, datos.origen, datos.destino, datos.opts);
+    trace::ArbolCaminos caminos;
+    if (binario || csr) {
+      // Congelamos el grafo en CSR (o usamos el binario tal cual) y buscamos sobre los arrays contiguos
+      const GrafoCsr grafo_csr = binario ? io::AbrirGrafoBinario(fichero_grafo, opciones_lectura.comprobacion) : GrafoCsr(datos.grafo);
+      n = grafo_csr.GetNumVertices();
+      m = grafo_csr.GetNumAristas();
+      if (todos) caminos = busq.BfsTodos(grafo_csr, origen);
+      else resultado = Buscar(busq, grafo_csr, datos, opciones_lectura.hilos);
     } else {
-      resultado = busq.Dfs(datos.grafo, datos.origen, datos.destino, datos.opts);
+      // Obtenemos n que es el número de nodos del grafo
+      n = datos.grafo.GetNumVertices();
+      // Obtenemos m que es el número de aristas del grafo
+      // Para ello, sumamos el número de vecinos de cada nodo y dividimos entre 2
+      // (porque el grafo es no dirigido y cada arista aparece dos veces).
+      for (int i = 1; i <= n; ++i) m += datos.grafo.GetVecinosPorId(i).size();
+      m /= 2;  // cada arista aparece dos veces en vecinos (grafo no dirigido)
+      if (todos) caminos = busq.BfsTodos(datos.grafo, origen);
+      else resultado = Buscar(busq, datos.grafo, datos, opciones_lectura.hilos);
     }
 
     // Impresión
-    // Obtenemos n que es el número de nodos del grafo
-    const int n = datos.grafo.GetNumVertices();
-    // Obtenemos m que es el número de aristas del grafo
-    // Para ello, sumamos el número de vecinos de cada nodo y dividimos entre 2
-    // (porque el grafo es no dirigido y cada arista aparece dos veces).
-    size_t m = 0;
-    for (int i = 1; i <= n; ++i) m += datos.grafo.GetVecinosPorId(i).size();
-    m /= 2;  // cada arista aparece dos veces en vecinos (grafo no dirigido)
 
     fout << "-----------------------------------------\n";
     fout << "Número de nodos del grafo: " << n << "\n";
     fout << "Número de aristas del grafo: " << m << "\n";
     fout << "Vértice origen: " << origen << "\n";
-    fout << "Vértice destino: " << destino << "\n";
-    // io::ImprimirTraza(fout, resultado, acumulada);
-    io::ImprimirTrazaEstiloGuion(fout, resultado, origen);
-    io::ImprimirSolucion(fout, resultado);
-    io::ImprimirResumen(fout, resultado);
+    if (todos) {
+      fout << "Vértice destino: todos\n";
+      // La traza y los contadores se imprimen igual que en una búsqueda normal
+      resultado.traza = std::move(caminos.traza);
+      resultado.nodos_generados = caminos.nodos_generados;
+      resultado.nodos_inspeccionados = caminos.nodos_inspeccionados;
+      io::ImprimirTrazaEstiloGuion(fout, resultado, origen);
+      io::ImprimirCaminos(fout, caminos);
+      io::ImprimirResumen(fout, resultado);
+    } else {
+      fout << "Vértice destino: " << destino << "\n";
+      // io::ImprimirTraza(fout, resultado, acumulada);
+      io::ImprimirTrazaEstiloGuion(fout, resultado, origen);
+      io::ImprimirSolucion(fout, resultado);
+      io::ImprimirMejoresSoluciones(fout, resultado);
+      io::ImprimirResumen(fout, resultado);
+    }
 
   } catch (const std::exception& e) {
     std::cerr << "Error: " << e.what() << "\n";
@@ -82,4 +292,4 @@ int main(int argc, char* argv[]) {
   }
 
   return 0;
-}
\ No newline at end of file
+}
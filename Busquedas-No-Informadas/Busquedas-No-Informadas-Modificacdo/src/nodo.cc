@@ -10,25 +10,30 @@ void Nodo::AnadirVecino(int vecino_id, double peso) {
     throw std::invalid_argument ("El peso de la arista no puede ser negativo");
   }
 
+  // Mantenemos los vecinos ordenados, asi el grafo garantiza que siempre duvuelvan los vecinos ordenados 
+  // y BFS/DFS recorren en orden determinista (siempre se visitara los nodos en el mismo orden).
+  // Buscamos en binario la posición que le toca al vecino
+  auto it = std::lower_bound(vecinos_.begin(), vecinos_.end(), vecino_id,
+                             [](const std::pair<int, double>& vecino, int id) { return vecino.first < id; });
+
   // Si existe, actualizamos y salimos
-  for (auto& vecino: vecinos_) {
-    if (vecino.first == vecino_id) {
-      vecino.second = peso;
-      return; 
-    } 
+  if (it != vecinos_.end() && it->first == vecino_id) {
+    it->second = peso;
+    return;
   }
 
-  // Si no existe, lo añadimos
-  vecinos_.emplace_back(vecino_id, peso);
-
-  // Ordenamos los vecinos, asi el grafo garantiza que siempre duvuelvan los vecinos ordenados 
-  // y BFS/DFS recorren en orden determinista (siempre se visitara los nodos en el mismo orden).
-  std::sort(vecinos_.begin(), vecinos_.end());
+  // Si no existe, lo insertamos en su sitio (sin reordenar toda la lista)
+  vecinos_.emplace(it, vecino_id, peso);
 }
 
 bool Nodo::TieneVecino(int vecino_id) const {
-  for (const auto& vecino : vecinos_) {
-    if (vecino.first == vecino_id) return true;
-  }
-  return false;
+  return GetPesoVecino(vecino_id) != -1.0;
+}
+
+double Nodo::GetPesoVecino(int vecino_id) const {
+  // vecinos_ está siempre ordenado por id (ver AnadirVecino), así que buscamos en binario
+  auto it = std::lower_bound(vecinos_.begin(), vecinos_.end(), vecino_id,
+                             [](const std::pair<int, double>& vecino, int id) { return vecino.first < id; });
+  if (it == vecinos_.end() || it->first != vecino_id) return -1.0;
+  return it->second;
 }
\ No newline at end of file